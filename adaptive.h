@@ -0,0 +1,237 @@
+// Front-ends that pick the shortest path or minimum spanning tree
+// algorithm to run from cheap statistics of the graph, so callers get
+// the fastest variant without hard-coding one:
+//
+// - Dijkstra with the vectorized linear-scan queue ('shortest_path3')
+//   while the graph is small enough for the open set to stay small,
+//   with the binary heap ('shortest_path2') beyond. The plain linear
+//   scan ('shortest_path') never wins on its own.
+// - Kruskal while the graph is sparse enough for sorting all the
+//   edges to beat Prim: the radix sort skips the bytes that are the
+//   same for all the weights, so the break-even degree depends on the
+//   range of the weights (and is lowest for floating point weights).
+//   Otherwise Prim, with the scan queue ('mst3') on small graphs and
+//   the heap ('mst2') on large ones.
+//
+// The thresholds live in a 'profile', whose defaults were measured by
+// tune.cc on the graph families of the benchmarks (see bench.cc).
+// Machines differ, so tune.cc can measure the crossovers on the
+// machine at hand and write a profile file for 'profile::load'.
+//
+// The statistics look at the vertex count and a sample of the
+// vertices' edges only, so they're cheap next to any of the
+// algorithms, even for a short path query.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <fstream>
+#include <memory_resource>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "dijkstra.h"
+#include "graph.h"
+#include "instrument.h"
+#include "kruskal.h"
+#include "prim.h"
+#include "sort.h"
+
+namespace adaptive {
+
+  // Cheap statistics of a graph: exact vertex count, the rest estimated
+  // from a sample of vertices (exact when the graph is small).
+  template <common::Numeric E>
+  struct graph_stats {
+    uint64_t vertices = 0;
+    uint64_t edges = 0;
+    double avg_degree = 0;
+    E min_weight{};
+    E max_weight{};
+    // Bytes of the weights' radix sort keys that vary (so the number
+    // of passes a radix sort by weight makes).
+    uint sort_passes = 1;
+    // Whether the weights are a type the scan queues vectorize (see
+    // simd.h).
+    bool vectorizable = std::floating_point<E> ||
+      (std::signed_integral<E> && (sizeof(E) == 4 || sizeof(E) == 8));
+  };
+
+  // Measure [g], sampling the edges of (at most) its first [sample]
+  // vertices.
+  template <common::WeightedGraph G>
+  graph_stats<common::label_t<G>> measure(const G &g, uint sample = 1024) {
+    using E = common::label_t<G>;
+    graph_stats<E> s;
+    s.vertices = g.num_vertices();
+
+    uint64_t sampled = 0, degrees = 0;
+    bool any = false;
+    for (const auto &v : g.vertex_view()) {
+      if (sampled == sample) {
+        break;
+      }
+      sampled++;
+      for (const auto &e : g.out_edges(v)) {
+        degrees++;
+        if (!any || e.label < s.min_weight) {
+          s.min_weight = e.label;
+        }
+        if (!any || e.label > s.max_weight) {
+          s.max_weight = e.label;
+        }
+        any = true;
+      }
+    }
+
+    if constexpr (requires { g.num_edges(); }) {
+      s.edges = g.num_edges();
+    } else {
+      s.edges = sampled ? degrees * s.vertices / sampled : 0;
+    }
+    s.avg_degree = s.vertices ? static_cast<double>(s.edges) / s.vertices : 0;
+
+    const auto diff = sort::_radix_key(s.min_weight) ^ sort::_radix_key(s.max_weight);
+    s.sort_passes = std::max<uint>(1, (std::bit_width(diff) + 7) / 8);
+    return s;
+  }
+
+  enum class path_backend { scan, heap };
+  enum class mst_backend { kruskal, prim_scan, prim_heap };
+
+  inline const char *name(path_backend b) {
+    return b == path_backend::scan ? "dijkstra::shortest_path3" : "dijkstra::shortest_path2";
+  }
+
+  inline const char *name(mst_backend b) {
+    return b == mst_backend::kruskal ? "kruskal::mst"
+      : b == mst_backend::prim_scan ? "prim::mst3"
+      : "prim::mst2";
+  }
+
+  // Crossover points between the algorithms.
+  struct profile {
+    // Most vertices for which Dijkstra with a scan queue beats the
+    // heap.
+    uint64_t path_scan_max_vertices = 6000;
+    // Most vertices for which Prim with a scan queue beats the heap.
+    uint64_t mst_scan_max_vertices = 4500;
+    // Largest average degree for which Kruskal beats Prim, by the
+    // number of radix sort passes the weights need (1 to 8).
+    std::array<double, 8> kruskal_max_degree{28, 26, 24, 24, 22, 20, 18, 16};
+
+    // Read a profile written by 'save' (keys missing from the file
+    // keep their defaults).
+    static profile load(const std::string &path) {
+      std::ifstream fs(path);
+      if (!fs) {
+        throw std::runtime_error("can't open " + path);
+      }
+      profile p;
+      for (std::string line; std::getline(fs, line);) {
+        std::istringstream ss(line);
+        std::string key;
+        if (!(ss >> key) || key.starts_with("#")) {
+          continue;
+        }
+        bool ok;
+        if (key == "path_scan_max_vertices") {
+          ok = static_cast<bool>(ss >> p.path_scan_max_vertices);
+        } else if (key == "mst_scan_max_vertices") {
+          ok = static_cast<bool>(ss >> p.mst_scan_max_vertices);
+        } else if (key == "kruskal_max_degree") {
+          ok = true;
+          for (auto &d : p.kruskal_max_degree) {
+            ok = ok && static_cast<bool>(ss >> d);
+          }
+        } else {
+          throw std::runtime_error("unknown key " + key + " in " + path);
+        }
+        if (!ok) {
+          throw std::runtime_error("bad value for " + key + " in " + path);
+        }
+      }
+      return p;
+    }
+
+    void save(const std::string &path) const {
+      std::ofstream fs(path);
+      fs << "# Algorithm crossovers (see adaptive.h)\n"
+         << "path_scan_max_vertices " << this->path_scan_max_vertices << "\n"
+         << "mst_scan_max_vertices " << this->mst_scan_max_vertices << "\n"
+         << "kruskal_max_degree";
+      for (const double d : this->kruskal_max_degree) {
+        fs << " " << d;
+      }
+      fs << "\n";
+      if (!fs) {
+        throw std::runtime_error("can't write " + path);
+      }
+    }
+  };
+
+  template <common::Numeric E>
+  path_backend choose_path(const graph_stats<E> &s, const profile &p = {}) {
+    if (s.vectorizable && s.vertices <= p.path_scan_max_vertices) {
+      return path_backend::scan;
+    }
+    return path_backend::heap;
+  }
+
+  template <common::Numeric E>
+  mst_backend choose_mst(const graph_stats<E> &s, const profile &p = {}) {
+    const uint passes = std::clamp<uint>(s.sort_passes, 1, p.kruskal_max_degree.size());
+    if (s.avg_degree <= p.kruskal_max_degree[passes - 1]) {
+      return mst_backend::kruskal;
+    }
+    if (s.vectorizable && s.vertices <= p.mst_scan_max_vertices) {
+      return mst_backend::prim_scan;
+    }
+    return mst_backend::prim_heap;
+  }
+
+  // Find the shortest path in [g] from [src] to [dest] with the
+  // Dijkstra variant [p] picks for it.
+  template <common::WeightedGraph G,
+            instrument::Policy S = instrument::none>
+  std::vector<common::edge_t<G>> shortest_path(const G &g,
+                                               const common::vertex_t<G> &src,
+                                               const common::vertex_t<G> &dest,
+                                               const profile &p = {},
+                                               std::pmr::memory_resource *mr =
+                                               std::pmr::get_default_resource(),
+                                               S &stats = instrument::off) {
+    switch (choose_path(measure(g), p)) {
+    case path_backend::scan:
+      return dijkstra::shortest_path3(g, src, dest, mr, stats);
+    default:
+      return dijkstra::shortest_path2(g, src, dest, mr, stats);
+    }
+  }
+
+  // Minimum spanning forest of [g] with the algorithm [p] picks for
+  // it.
+  template <common::WeightedGraph G,
+            instrument::Policy S = instrument::none>
+  std::vector<common::edge_t<G>> mst(const G &g,
+                                     const profile &p = {},
+                                     std::pmr::memory_resource *mr =
+                                     std::pmr::get_default_resource(),
+                                     S &stats = instrument::off) {
+    switch (choose_mst(measure(g), p)) {
+    case mst_backend::kruskal:
+      return kruskal::mst(g, mr, stats);
+    case mst_backend::prim_scan:
+      return prim::mst3(g, mr, stats);
+    default:
+      return prim::mst2(g, mr, stats);
+    }
+  }
+}
@@ -0,0 +1,355 @@
+// ALT heuristics for A* (Goldberg & Harrelson, "Computing the Shortest
+// Path: A* Search Meets Graph Theory"): A*, Landmarks and the Triangle
+// inequality. A few landmark vertices are chosen up front, and the
+// distances from each landmark to every vertex and from every vertex
+// to each landmark are stored. By the triangle inequality, for any
+// landmark L
+//
+//   d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L),
+//
+// so the largest of these bounds over the landmarks is an admissible
+// (and consistent) heuristic for A* on any graph with nonnegative
+// weights, with no geometry needed. Landmarks "behind" the source or
+// "beyond" the destination give tight bounds, so A* settles far fewer
+// vertices than Dijkstra.
+//
+// Landmarks are chosen by one of two strategies:
+//
+// - farthest: each new landmark is the vertex farthest from the
+//   landmarks chosen so far;
+// - avoid (Goldberg & Werneck): grow a shortest path tree from a
+//   random root, weigh each vertex by how badly the current landmarks
+//   bound its distance from the root, and descend into the heaviest
+//   subtree that has no landmark yet. Its leaf is the new landmark.
+//   Usually gives better bounds than farthest.
+//
+// The distance tables are stored vertex-major (the k distances of a
+// vertex are contiguous, so a heuristic evaluation reads one or two
+// cache lines), and only once for undirected graphs, where both
+// directions are the same.
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+#include "graph.h"
+
+namespace alt {
+
+  enum class strategy { farthest, avoid };
+}
+
+template <typename V, common::Numeric E>
+class alt_landmarks {
+public:
+  // Distance to or from vertices that can't be reached.
+  static constexpr E unreachable = std::numeric_limits<E>::max();
+
+  // Choose [k] landmarks of [g] (fewer if [g] has fewer vertices) with
+  // strategy [s], using [seed] for the random choices, and compute
+  // their distance tables.
+  template <common::WeightedGraph G>
+  requires std::same_as<common::vertex_t<G>, V> && std::same_as<common::label_t<G>, E>
+  alt_landmarks(const G &g, uint k, alt::strategy s = alt::strategy::avoid, uint64_t seed = 0) {
+    // Vertices are numbered (in sorted order when possible, so the
+    // choices don't depend on the hash order), and the adjacency is
+    // copied in both directions.
+    auto view = g.vertex_view();
+    this->_vertices.assign(view.begin(), view.end());
+    if constexpr (std::totally_ordered<V>) {
+      std::sort(this->_vertices.begin(), this->_vertices.end());
+    }
+    const uint n = this->_vertices.size();
+    this->_index.reserve(n);
+    for (uint i = 0; i < n; i++) {
+      this->_index[this->_vertices[i]] = i;
+    }
+    const _csr fwd(g, this->_vertices, this->_index, false);
+    const _csr rev(g, this->_vertices, this->_index, true);
+
+    k = std::min(k, n);
+    std::vector<std::vector<E>> from, to; // Per landmark, for now.
+    std::vector<bool> chosen(n, false);
+    std::mt19937_64 rng(seed);
+    auto random_vertex = [&rng, n]() {
+      return static_cast<uint>(std::uniform_int_distribution<uint64_t>(0, n - 1)(rng));
+    };
+
+    // Smallest distance of each vertex from the landmarks so far.
+    std::vector<E> nearest(n, unreachable);
+    auto farthest = [&]() {
+      uint best = 0;
+      for (uint i = 0; i < n; i++) {
+        if (!chosen[i] && (chosen[best] || nearest[i] > nearest[best])) {
+          best = i;
+        }
+      }
+      return best;
+    };
+
+    for (uint j = 0; j < k; j++) {
+      uint l;
+      if (j == 0 && s == alt::strategy::farthest) {
+        // Farthest from a random vertex.
+        nearest = fwd.distances(random_vertex());
+        l = farthest();
+      } else if (s == alt::strategy::farthest) {
+        l = farthest();
+      } else {
+        l = this->_avoid(fwd, from, to, chosen, random_vertex());
+        if (chosen[l]) {
+          l = farthest();
+        }
+      }
+      if (chosen[l]) {
+        // All vertices are landmarks already.
+        break;
+      }
+      chosen[l] = true;
+      this->_landmarks.push_back(this->_vertices[l]);
+      from.push_back(fwd.distances(l));
+      to.push_back(rev.distances(l));
+      if (j == 0 && s == alt::strategy::farthest) {
+        nearest = from.back();
+      } else {
+        for (uint i = 0; i < n; i++) {
+          nearest[i] = std::min(nearest[i], from.back()[i]);
+        }
+      }
+    }
+
+    // Flatten the tables, vertex-major.
+    this->_k = this->_landmarks.size();
+    this->_symmetric = from == to;
+    this->_from.resize(uint64_t{n} * this->_k);
+    for (uint i = 0; i < n; i++) {
+      for (uint j = 0; j < this->_k; j++) {
+        this->_from[uint64_t{i} * this->_k + j] = from[j][i];
+      }
+    }
+    if (!this->_symmetric) {
+      this->_to.resize(uint64_t{n} * this->_k);
+      for (uint i = 0; i < n; i++) {
+        for (uint j = 0; j < this->_k; j++) {
+          this->_to[uint64_t{i} * this->_k + j] = to[j][i];
+        }
+      }
+    }
+  }
+
+  const std::vector<V> &landmarks() const {
+    return this->_landmarks;
+  }
+
+  constexpr uint size() const {
+    return this->_k;
+  }
+
+  // Size of the distance tables in bytes.
+  std::size_t bytes() const {
+    return (this->_from.size() + this->_to.size()) * sizeof(E);
+  }
+
+  // Lower bound on the distance from [u] to [v] (0 if either is
+  // unknown).
+  E lower_bound(const V &u, const V &v) const {
+    const auto iu = this->_index.find(u);
+    const auto iv = this->_index.find(v);
+    if (iu == this->_index.end() || iv == this->_index.end()) {
+      return 0;
+    }
+    return this->_bound(iu->second, iv->second);
+  }
+
+  // ALT heuristic for A* searches to [dest] (an astar::heuristic, see
+  // astar.h). Refers to this object, which must outlive it.
+  std::function<E(const V&)> heuristic(const V &dest) const {
+    const auto it = this->_index.find(dest);
+    if (it == this->_index.end()) {
+      throw std::invalid_argument("destination doesn't exist");
+    }
+    const uint t = it->second;
+    return [this, t](const V &v) {
+      const auto iv = this->_index.find(v);
+      return iv == this->_index.end() ? E{0} : this->_bound(iv->second, t);
+    };
+  }
+
+private:
+  // Adjacency by vertex number, forward or reversed.
+  struct _csr {
+    std::vector<uint> offsets;
+    std::vector<std::pair<uint, E>> adj;
+
+    template <typename G>
+    _csr(const G &g, const std::vector<V> &vs, const std::unordered_map<V, uint> &index,
+         bool reversed)
+      : offsets(vs.size() + 1, 0) {
+      std::vector<std::pair<uint, std::pair<uint, E>>> es;
+      for (uint i = 0; i < vs.size(); i++) {
+        for (const auto &e : g.out_edges(vs[i])) {
+          const uint j = index.at(e.v2);
+          es.push_back(reversed ? std::pair(j, std::pair(i, e.label))
+                                : std::pair(i, std::pair(j, e.label)));
+        }
+      }
+      for (const auto &[i, e] : es) {
+        this->offsets[i + 1]++;
+      }
+      for (uint i = 0; i + 1 < this->offsets.size(); i++) {
+        this->offsets[i + 1] += this->offsets[i];
+      }
+      this->adj.resize(es.size());
+      std::vector<uint> next(this->offsets.begin(), this->offsets.end() - 1);
+      for (const auto &[i, e] : es) {
+        this->adj[next[i]++] = e;
+      }
+    }
+
+    // Shortest path distances from [src] (and, if [parent] isn't null,
+    // the shortest path tree and the vertices in the order they were
+    // settled).
+    std::vector<E> distances(uint src, std::vector<uint> *parent = nullptr,
+                             std::vector<uint> *order = nullptr) const {
+      const uint n = this->offsets.size() - 1;
+      std::vector<E> dist(n, unreachable);
+      if (parent) {
+        parent->assign(n, n);
+        order->clear();
+      }
+      using item = std::pair<E, uint>;
+      std::priority_queue<item, std::vector<item>, std::greater<item>> open;
+      dist[src] = 0;
+      open.push({0, src});
+      while (!open.empty()) {
+        const auto [d, u] = open.top();
+        open.pop();
+        if (d > dist[u]) {
+          continue;
+        }
+        if (order) {
+          order->push_back(u);
+        }
+        for (uint x = this->offsets[u]; x < this->offsets[u + 1]; x++) {
+          const auto [v, w] = this->adj[x];
+          if (d + w < dist[v]) {
+            dist[v] = d + w;
+            if (parent) {
+              (*parent)[v] = u;
+            }
+            open.push({dist[v], v});
+          }
+        }
+      }
+      return dist;
+    }
+  };
+
+  std::vector<V> _vertices;
+  std::unordered_map<V, uint> _index;
+  std::vector<V> _landmarks;
+  uint _k = 0;
+  bool _symmetric = false;
+  std::vector<E> _from; // _from[i * k + j] = d(landmark j, vertex i).
+  std::vector<E> _to;   // _to[i * k + j] = d(vertex i, landmark j) (empty if symmetric).
+
+  // Lower bound on d(u, v) given by the distances d(L, u) = [from_u],
+  // d(L, v) = [from_v], d(u, L) = [to_u] and d(v, L) = [to_v] of some
+  // landmark L (0 where they're unreachable).
+  static E _gap(E from_u, E from_v, E to_u, E to_v) {
+    E h = 0;
+    if (from_u != unreachable && from_v != unreachable && from_v > from_u) {
+      h = from_v - from_u;
+    }
+    if (to_u != unreachable && to_v != unreachable && to_u > to_v) {
+      h = std::max<E>(h, to_u - to_v);
+    }
+    return h;
+  }
+
+  // Lower bound on d(u, v) over all the landmarks, by vertex numbers.
+  E _bound(uint u, uint v) const {
+    const E *from_u = this->_from.data() + uint64_t{u} * this->_k;
+    const E *from_v = this->_from.data() + uint64_t{v} * this->_k;
+    const E *to = this->_symmetric ? this->_from.data() : this->_to.data();
+    const E *to_u = to + uint64_t{u} * this->_k;
+    const E *to_v = to + uint64_t{v} * this->_k;
+    E h = 0;
+    for (uint j = 0; j < this->_k; j++) {
+      h = std::max(h, _gap(from_u[j], from_v[j], to_u[j], to_v[j]));
+    }
+    return h;
+  }
+
+  // Next landmark by the avoid strategy, from root [r] given the
+  // (per landmark) tables so far.
+  uint _avoid(const _csr &fwd, const std::vector<std::vector<E>> &from,
+              const std::vector<std::vector<E>> &to, const std::vector<bool> &chosen,
+              uint r) const {
+    const uint n = this->_vertices.size();
+    std::vector<uint> parent, order;
+    const std::vector<E> dist = fwd.distances(r, &parent, &order);
+
+    // Weight of each vertex: the gap between its distance from the
+    // root and the current lower bound on it. The size of a subtree is
+    // its total weight, or 0 if it contains a landmark.
+    std::vector<E> size(n, 0);
+    std::vector<bool> covered(n, false);
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+      const uint v = *it;
+      if (chosen[v]) {
+        covered[v] = true;
+      }
+      if (covered[v]) {
+        size[v] = 0;
+      } else {
+        E lb = 0;
+        for (uint j = 0; j < from.size(); j++) {
+          lb = std::max(lb, _gap(from[j][r], from[j][v], to[j][r], to[j][v]));
+        }
+        size[v] += dist[v] - lb;
+      }
+      if (v != r) {
+        covered[parent[v]] = covered[parent[v]] || covered[v];
+        size[parent[v]] += size[v];
+      }
+    }
+
+    // Descend from the root into the largest subtree until reaching a
+    // leaf. Children are found by scanning the tree edges.
+    std::vector<uint> first_child(n, n), next_sibling(n, n);
+    for (const uint v : order) {
+      if (v != r) {
+        next_sibling[v] = first_child[parent[v]];
+        first_child[parent[v]] = v;
+      }
+    }
+    uint cur = r;
+    for (;;) {
+      uint best = n;
+      for (uint c = first_child[cur]; c != n; c = next_sibling[c]) {
+        if (size[c] > 0 && (best == n || size[c] > size[best])) {
+          best = c;
+        }
+      }
+      if (best == n) {
+        break;
+      }
+      cur = best;
+    }
+    return cur;
+  }
+};
+
+template <common::WeightedGraph G>
+alt_landmarks(const G&, uint, alt::strategy = alt::strategy::avoid, uint64_t = 0)
+  -> alt_landmarks<common::vertex_t<G>, common::label_t<G>>;
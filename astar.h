@@ -4,45 +4,63 @@
 // extra overhead of calling the heuristic function). Need to
 // test/compare on another problem for which a suitable heuristic is
 // available. Euclidean and Manhattan distance heuristics don't seem
-// useful at all for PE#83.
+// useful at all for PE#83. Landmark (ALT) heuristics, which need no
+// geometry, do prune on any graph: see alt.h.
 
 #pragma once
 
 #include <functional>
+#include <memory_resource>
 #include <utility>
 
 #include "common.h"
 #include "graph.h"
+#include "instrument.h"
+#include "scan_heap.h"
 
 namespace astar {
 
+  // Heuristic estimate of the distance from a vertex to the
+  // destination.
+  template <typename G>
+  using heuristic = std::function<common::label_t<G>(const common::vertex_t<G>&)>;
+
   // Find the shortest path in [g] from [src] to [dest] using
-  // heuristic function [h].
-  template <typename V, common::Numeric E>
-  std::vector<edge<V, E>> shortest_path(const graph<V, E> &g,
-                                        const V &src,
-                                        const V &dest,
-                                        const std::function<E(const V&)> &h) {
-    // Mapping of each vertex to its current tentative distance value.
-    std::unordered_map<V, E> dist;
+  // heuristic function [h]. All scratch state is allocated from
+  // memory resource [mr] (see workspace.h), and operation counts are
+  // recorded by instrumentation policy [stats] (see instrument.h).
+  template <common::WeightedGraph G,
+            instrument::Policy S = instrument::none>
+  std::vector<common::edge_t<G>> shortest_path(const G &g,
+                                               const common::vertex_t<G> &src,
+                                               const common::vertex_t<G> &dest,
+                                               const heuristic<G> &h,
+                                               std::pmr::memory_resource *mr =
+                                               std::pmr::get_default_resource(),
+                                               S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    // Count scratch allocations (when instrumented).
+    instrument::resource<S> counted(mr, stats);
+    mr = counted.get();
+
+    // Mapping of each vertex to its current tentative distance value
+    // (vertices not in the map have max distance value).
+    std::pmr::unordered_map<V, E> dist(mr);
 
     // Mapping of each vertex to its immediate predecessor on the
     // current best-known path from the source.
-    std::unordered_map<V, V> pred;
+    std::pmr::unordered_map<V, V> pred(mr);
 
     // Open set (priority queue).
-    std::vector<V> open{src};
+    std::pmr::vector<V> open({src}, mr);
 
-    std::function<E(const V&)> f = [&dist = std::as_const(dist),
-                                    &h = std::as_const(h)](const V &v) {
+    auto f = [&dist = std::as_const(dist),
+              &h = std::as_const(h)](const V &v) {
       return dist.at(v) + h(v);
     };
 
-    // Initialize all vertices with max distance value.
-    for (const auto &v : g.vertices()) {
-      dist[v] = std::numeric_limits<E>::max();
-    }
-
     // Initialize source vertex tentative distance value.
     dist[src] = 0;
 
@@ -52,18 +70,94 @@ namespace astar {
       uint min_i = common::min_index(open, f);
       V u = open[min_i];
       open.erase(open.begin() + min_i);
+      stats.extract();
+      stats.settle();
 
       if (u == dest) {
         return common::build_path(g, pred, src, dest);
       }
 
-      for (const auto &e : g.edges(u)) {
-        const E d = dist[u] + e.label;
-        if (d < dist[e.v2]) {
+      const E du = dist.at(u);
+      for (const auto &e : g.out_edges(u)) {
+        stats.relax();
+        const E d = du + e.label;
+        if (auto it = dist.find(e.v2); it == dist.end() || d < it->second) {
           dist[e.v2] = d;
           pred[e.v2] = u;
           if (!common::contains(open, e.v2)) {
             open.push_back(e.v2);
+            stats.heap_insert();
+          } else {
+            stats.decrease_key();
+          }
+        }
+      }
+    }
+
+    // If we've processed all vertices and never encountered the
+    // destination, then it must not have existed in the graph.
+    throw std::invalid_argument("destination doesn't exist");
+  }
+
+  // Alternate version that keeps the f scores of the open set in a
+  // contiguous array (see scan_heap.h), so the heuristic is evaluated
+  // once per insertion or improvement rather than on every scan, and
+  // the minimum is found with a vectorized argmin.
+  template <common::WeightedGraph G,
+            instrument::Policy S = instrument::none>
+  std::vector<common::edge_t<G>> shortest_path2(const G &g,
+                                                const common::vertex_t<G> &src,
+                                                const common::vertex_t<G> &dest,
+                                                const heuristic<G> &h,
+                                                std::pmr::memory_resource *mr =
+                                                std::pmr::get_default_resource(),
+                                                S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    // Count scratch allocations (when instrumented).
+    instrument::resource<S> counted(mr, stats);
+    mr = counted.get();
+
+    // Mapping of each vertex to its current tentative distance value
+    // (vertices not in the map have max distance value).
+    std::pmr::unordered_map<V, E> dist(mr);
+
+    // Mapping of each vertex to its immediate predecessor on the
+    // current best-known path from the source.
+    std::pmr::unordered_map<V, V> pred(mr);
+
+    // Initialize source vertex tentative distance value.
+    dist[src] = 0;
+
+    // Open set, prioritized by f score (distance plus heuristic).
+    scan_heap<V, E> open(mr);
+    open.insert(src, h(src));
+
+    // Main loop.
+    while (open.size()) {
+      // Remove the vertex with the smallest f score from the open set.
+      V u = open.extract().first;
+      stats.extract();
+      stats.settle();
+
+      if (u == dest) {
+        return common::build_path(g, pred, src, dest);
+      }
+
+      const E du = dist.at(u);
+      for (const auto &e : g.out_edges(u)) {
+        stats.relax();
+        const E d = du + e.label;
+        if (auto it = dist.find(e.v2); it == dist.end() || d < it->second) {
+          dist[e.v2] = d;
+          pred[e.v2] = u;
+          if (!open.contains(e.v2)) {
+            open.insert(e.v2, d + h(e.v2));
+            stats.heap_insert();
+          } else {
+            open.decrease_key(e.v2, d + h(e.v2));
+            stats.decrease_key();
           }
         }
       }
@@ -0,0 +1,615 @@
+// Benchmarks comparing the algorithm variants against each other on
+// synthetic inputs of increasing size (see generators.h) and on the
+// Project Euler inputs used by main.cc. Each case runs in a forked
+// child process (sharing the already built input) so that peak RSS
+// can be measured per case. Results are written to stdout as JSON
+// lines, one object per case:
+//
+//   {"case": "dijkstra::shortest_path2", "input": "grid", "size": 1000,
+//    "vertices": 1024, "edges": 3968, "reps": 3, "time_s": ...,
+//    "mean_s": ..., "edges_per_sec": ..., "peak_rss_kb": ...,
+//    "input_rss_kb": ...}
+//
+// 'time_s' is the best of 'reps' runs, 'peak_rss_kb' is the peak RSS
+// of the child (including the input it shares with the parent) and
+// 'input_rss_kb' the RSS of the parent after building the input. For
+// the sorting cases 'edges_per_sec' is the number of keys sorted per
+// second.
+//
+// Quadratic cases are skipped (with "skipped": true) above
+// --quadratic-max. With --counters 1, each case is run once more with
+// instrumentation (see instrument.h) and its operation counts are
+// added to the output as a "counters" object. Usage:
+//
+//   ./bench [--sizes 1000,10000,...] [--max-size N] [--quadratic-max N]
+//           [--reps N] [--filter SUBSTRING] [--seed N] [--counters 1]
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "adaptive.h"
+#include "alt.h"
+#include "astar.h"
+#include "compact_graph.h"
+#include "compressed_graph.h"
+#include "dense_bitset_graph.h"
+#include "dfs.h"
+#include "dijkstra.h"
+#include "external.h"
+#include "generators.h"
+#include "graph.h"
+#include "hda.h"
+#include "instrument.h"
+#include "kahn.h"
+#include "kruskal.h"
+#include "ksp.h"
+#include "msbfs.h"
+#include "prim.h"
+#include "reorder.h"
+#include "sort.h"
+#include "streaming_mst.h"
+#include "subgraph_view.h"
+
+using namespace std;
+
+struct options {
+  vector<uint> sizes{1000, 10000, 100000, 1000000, 10000000};
+  uint max_size = 10000000;
+  uint quadratic_max = 100000;
+  uint reps = 3;
+  string filter;
+  uint seed = 1;
+  bool counters = false;
+};
+
+// A benchmark input. Graph inputs carry a source and destination for
+// the path searches, a compact copy of the graph when any of the
+// "/compact" cases run on them, a delta and varint compressed copy
+// for the "/compressed" cases, and a compact copy in reverse
+// Cuthill-McKee order (see reorder.h) for the "/rcm" cases, and a bit
+// matrix copy for the "/dense" cases (small inputs only). Sorting
+// inputs only carry a vector of keys.
+struct input {
+  string name;
+  uint size;
+  graph<int, int> g;
+  optional<compact_graph<int, int>> compact;
+  optional<compressed_graph<int, int>> compressed;
+  optional<compact_graph<int, int>> rcm;
+  int rcm_src = 0;
+  int rcm_dest = 0;
+  optional<dense_bitset_graph<>> dense;
+  shared_ptr<csr_file<int, int>> external;
+  shared_ptr<alt_landmarks<int, int>> alt;
+  int src = 0;
+  int dest = 0;
+  uint64_t num_edges = 0;
+  vector<uint> keys;
+};
+
+struct bench_case {
+  string name;
+  string family;    // Name of the input family the case runs on.
+  bool quadratic;   // Whether to skip the case above --quadratic-max.
+  function<void(input&)> run;
+  function<void(input&, instrument::stats&)> count;
+};
+
+// Peak RSS of this process so far.
+long peak_rss_kb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+// Current RSS of this process.
+long rss_kb() {
+  long pages = 0, resident = 0;
+  ifstream("/proc/self/statm") >> pages >> resident;
+  return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+uint64_t count_edges(const graph<int, int> &g) {
+  uint64_t m = 0;
+  for (const auto &v : g.vertex_view()) {
+    m += g.out_degree(v);
+  }
+  return m;
+}
+
+// Square grid with about [n] vertices and random edge weights.
+input make_grid(uint n, uint seed) {
+  const uint side = max(2, static_cast<int>(sqrt(static_cast<double>(n))));
+  input in{"grid", n, gen::build(gen::grid<int, int>(side, side, seed, 9999))};
+  in.dest = side * side - 1;
+  return in;
+}
+
+// Undirected G(n, 4n). The destination is very likely (but not
+// certain) to be in the giant component with the source.
+input make_random(uint n, uint seed) {
+  input in{"random", n,
+           gen::build(gen::erdos_renyi<int, int>(n, 4 * n, seed, 9999), false)};
+  in.dest = n - 1;
+  return in;
+}
+
+// Undirected R-MAT graph with the next power of two from [n] vertices
+// and 4 edges per vertex.
+input make_rmat(uint n, uint seed) {
+  const uint scale = max(1, static_cast<int>(ceil(log2(n))));
+  input in{"rmat", n,
+           gen::build(gen::rmat<int, int>(scale, 4ull << scale, seed, 9999), false)};
+  // Connect the source and destination to the highest degree vertex
+  // so that the path searches have something to find.
+  in.dest = (1 << scale) - 1;
+  int hub = 0;
+  for (const auto &v : in.g.vertex_view()) {
+    if (in.g.out_degree(v) > in.g.out_degree(hub)) {
+      hub = v;
+    }
+  }
+  in.g.add_edge(in.src, hub, 9999, false, true);
+  in.g.add_edge(in.dest, hub, 9999, false, true);
+  return in;
+}
+
+// Random geometric graph with [n] vertices and average degree about 8.
+input make_geometric(uint n, uint seed) {
+  const double radius = sqrt(8 / (M_PI * n));
+  input in{"geometric", n,
+           gen::build(gen::geometric<int, int>(n, radius, seed, 9999))};
+  in.dest = n - 1;
+  return in;
+}
+
+// Random DAG with [n] vertices and 4n edges.
+input make_dag(uint n, uint seed) {
+  return {"dag", n, gen::build(gen::dag<int, int>(n, 4 * n, seed, 9999))};
+}
+
+input make_keys(uint n, uint seed) {
+  input in{"keys", n};
+  in.keys.resize(n);
+  for (uint i = 0; i < n; i++) {
+    in.keys[i] = gen::random(seed, 0, i);
+  }
+  return in;
+}
+
+vector<string> split(const string &s, char delim) {
+  vector<string> result;
+  stringstream ss(s);
+  for (string item; getline(ss, item, delim);) {
+    result.push_back(item);
+  }
+  return result;
+}
+
+// The PE#83 matrix, as built by main.cc.
+optional<input> load_pe83() {
+  ifstream fs("matrix.txt");
+  vector<vector<int>> m;
+  for (string line; getline(fs, line);) {
+    vector<int> row;
+    for (const auto &s : split(line, ',')) {
+      row.push_back(stoi(s));
+    }
+    m.push_back(row);
+  }
+  if (m.empty()) {
+    return {};
+  }
+  const int side = m.size();
+  input in{"pe83", static_cast<uint>(side * side)};
+  for (int v = 0; v < side * side; v++) {
+    in.g.add_vertex(v);
+  }
+  for (int i = 0; i < side; i++) {
+    for (int j = 0; j < side; j++) {
+      const int u = side * i + j;
+      if (i > 0) {
+        in.g.add_edge(u, u - side, m[i-1][j], true);
+        in.g.add_edge(u - side, u, m[i][j], true);
+      }
+      if (j > 0) {
+        in.g.add_edge(u, u - 1, m[i][j-1], true);
+        in.g.add_edge(u - 1, u, m[i][j], true);
+      }
+    }
+  }
+  in.dest = side * side - 1;
+  return in;
+}
+
+// The PE#107 network, as built by main.cc.
+optional<input> load_pe107() {
+  ifstream fs("network.txt");
+  vector<vector<string>> m;
+  for (string line; getline(fs, line);) {
+    m.push_back(split(line, ','));
+  }
+  if (m.empty()) {
+    return {};
+  }
+  input in{"pe107", static_cast<uint>(m.size())};
+  for (uint i = 0; i < m.size(); i++) {
+    in.g.add_vertex(i);
+  }
+  for (uint i = 0; i < m.size(); i++) {
+    for (uint j = 0; j < m[i].size(); j++) {
+      if (m[i][j] != "-") {
+        in.g.add_edge(i, j, stoi(m[i][j]), true);
+      }
+    }
+  }
+  in.dest = m.size() - 1;
+  return in;
+}
+
+// Case running [f], which is generic in the instrumentation policy
+// (see instrument.h) so that it can be both timed and counted.
+template <typename F>
+bench_case make_case(const string &name, const string &family, bool quadratic, F f) {
+  return {name, family, quadratic,
+          [f](input &in) { f(in, instrument::off); },
+          [f](input &in, instrument::stats &s) { f(in, s); }};
+}
+
+vector<bench_case> cases() {
+  const function<int(const int&)> h0 = [](const int&) { return 0; };
+  auto *mr = pmr::get_default_resource();
+  vector<bench_case> cs;
+  for (const string family : {"grid", "random", "rmat", "geometric", "pe83"}) {
+    cs.push_back(make_case("dijkstra::shortest_path", family, true, [mr](input &in, auto &s) {
+      dijkstra::shortest_path(in.g, in.src, in.dest, mr, s);
+    }));
+    cs.push_back(make_case("dijkstra::shortest_path2", family, false, [mr](input &in, auto &s) {
+      dijkstra::shortest_path2(in.g, in.src, in.dest, mr, s);
+    }));
+    cs.push_back(make_case("dijkstra::shortest_path_result", family, false, [mr](input &in, auto &s) {
+      dijkstra::shortest_path_result(in.g, in.src, in.dest, mr, s);
+    }));
+    cs.push_back(make_case("dijkstra::shortest_path2/compact", family, false, [mr](input &in, auto &s) {
+      dijkstra::shortest_path2(in.compact.value(), in.src, in.dest, mr, s);
+    }));
+    cs.push_back(make_case("dijkstra::shortest_path2/compressed", family, false, [mr](input &in, auto &s) {
+      dijkstra::shortest_path2(in.compressed.value(), in.src, in.dest, mr, s);
+    }));
+    cs.push_back(make_case("dijkstra::shortest_path2/rcm", family, false, [mr](input &in, auto &s) {
+      dijkstra::shortest_path2(in.rcm.value(), in.rcm_src, in.rcm_dest, mr, s);
+    }));
+    // With the variant picked by the default profile (see adaptive.h).
+    cs.push_back(make_case("adaptive::shortest_path", family, false, [mr](input &in, auto &s) {
+      adaptive::shortest_path(in.g, in.src, in.dest, {}, mr, s);
+    }));
+    // Settles vertices lazily through a generator until the target is
+    // found (overhead of the coroutine vs shortest_path2).
+    cs.push_back(make_case("dijkstra::nearest", family, false, [mr](input &in, auto&) {
+      dijkstra::nearest(in.g, in.src, {in.dest}, 1, mr);
+    }));
+    cs.push_back(make_case("dijkstra::shortest_path3", family, true, [mr](input &in, auto &s) {
+      dijkstra::shortest_path3(in.g, in.src, in.dest, mr, s);
+    }));
+    cs.push_back(make_case("astar::shortest_path", family, true, [mr, h0](input &in, auto &s) {
+      astar::shortest_path(in.g, in.src, in.dest, h0, mr, s);
+    }));
+    cs.push_back(make_case("astar::shortest_path2", family, true, [mr, h0](input &in, auto &s) {
+      astar::shortest_path2(in.g, in.src, in.dest, h0, mr, s);
+    }));
+    // With 16 landmarks (see alt.h), preprocessed with the input.
+    cs.push_back(make_case("astar::shortest_path2/alt", family, true, [mr](input &in, auto &s) {
+      astar::shortest_path2(in.g, in.src, in.dest, in.alt->heuristic(in.dest), mr, s);
+    }));
+    // On all hardware threads.
+    cs.push_back(make_case("hda::shortest_path/alt", family, false, [](input &in, auto&) {
+      hda::shortest_path(in.g, in.src, in.dest, in.alt->heuristic(in.dest));
+    }));
+    cs.push_back(make_case("ksp::yen", family, true, [](input &in, auto&) {
+      ksp::yen(in.g, in.src, in.dest, 10);
+    }));
+    cs.push_back(make_case("msbfs::reachable/compact", family, false, [](input &in, auto&) {
+      // 64 sources spread over the vertices.
+      vector<int> sources;
+      for (uint k = 0; k < 64; k++) {
+        sources.push_back(in.compact->label(k * (in.compact->num_vertices() / 64)));
+      }
+      msbfs::reachable(in.compact.value(), sources);
+    }));
+    cs.push_back(make_case("msbfs::reachable/compressed", family, false, [](input &in, auto&) {
+      vector<int> sources;
+      for (uint k = 0; k < 64; k++) {
+        sources.push_back(in.compressed->label(k * (in.compressed->num_vertices() / 64)));
+      }
+      msbfs::reachable(in.compressed.value(), sources);
+    }));
+    cs.push_back(make_case("external::bfs", family, false, [](input &in, auto&) {
+      external::bfs(*in.external, in.src);
+    }));
+    cs.push_back(make_case("dfs::find_path", family, false, [mr](input &in, auto &s) {
+      dfs::find_path(in.g, in.src, in.dest, mr, s);
+    }));
+  }
+  for (const string family : {"grid", "random", "rmat", "geometric", "pe107"}) {
+    cs.push_back(make_case("prim::mst", family, true, [mr](input &in, auto &s) {
+      prim::mst(in.g, mr, s);
+    }));
+    cs.push_back(make_case("prim::mst2", family, false, [mr](input &in, auto &s) {
+      prim::mst2(in.g, mr, s);
+    }));
+    cs.push_back(make_case("adaptive::mst", family, false, [mr](input &in, auto &s) {
+      adaptive::mst(in.g, {}, mr, s);
+    }));
+    cs.push_back(make_case("prim::mst2/compact", family, false, [mr](input &in, auto &s) {
+      prim::mst2(in.compact.value(), mr, s);
+    }));
+    cs.push_back(make_case("prim::mst2/compressed", family, false, [mr](input &in, auto &s) {
+      prim::mst2(in.compressed.value(), mr, s);
+    }));
+    cs.push_back(make_case("prim::mst2/rcm", family, false, [mr](input &in, auto &s) {
+      prim::mst2(in.rcm.value(), mr, s);
+    }));
+    // "Graph minus closed roads": a view hiding a tenth of the edges,
+    // filtered during the search instead of copied (see
+    // subgraph_view.h).
+    cs.push_back(make_case("prim::mst2/filtered", family, false, [mr](input &in, auto &s) {
+      const auto open = subgraph::filter_edges(in.g, [](const edge<int, int> &e) {
+        return e.label % 10 != 0;
+      });
+      prim::mst2(open, mr, s);
+    }));
+    cs.push_back(make_case("prim::mst3", family, true, [mr](input &in, auto &s) {
+      prim::mst3(in.g, mr, s);
+    }));
+    cs.push_back(make_case("kruskal::mst", family, false, [mr](input &in, auto &s) {
+      kruskal::mst(in.g, mr, s);
+    }));
+    cs.push_back(make_case("kruskal::mst/compact", family, false, [mr](input &in, auto &s) {
+      kruskal::mst(in.compact.value(), mr, s);
+    }));
+    // Streams the graph's edges as if they came from a feed, keeping
+    // only the candidate forest.
+    cs.push_back(make_case("streaming_mst::mst", family, false, [](input &in, auto&) {
+      streaming_msf<int, int> msf;
+      for (const auto &v : in.g.vertex_view()) {
+        msf(in.g.out_edges(v));
+      }
+      msf.forest();
+    }));
+    cs.push_back(make_case("external::mst", family, false, [](input &in, auto&) {
+      external::mst(*in.external);
+    }));
+  }
+  cs.push_back(make_case("prim::mst2/dense", "pe107", false, [mr](input &in, auto &s) {
+    prim::mst2(in.dense.value(), mr, s);
+  }));
+  cs.push_back(make_case("kruskal::mst/dense", "pe107", false, [mr](input &in, auto &s) {
+    kruskal::mst(in.dense.value(), mr, s);
+  }));
+  cs.push_back(make_case("kahn::topsort", "dag", false, [](input &in, auto&) {
+    kahn::topsort(in.g);
+  }));
+  // The sorts run on a fresh copy of the keys each time.
+  cs.push_back(make_case("sort::bubble_sort", "keys", true, [](input &in, auto&) {
+    auto v = in.keys;
+    sort::bubble_sort(v);
+  }));
+  cs.push_back(make_case("sort::selection_sort", "keys", true, [](input &in, auto&) {
+    auto v = in.keys;
+    sort::selection_sort(v);
+  }));
+  cs.push_back(make_case("sort::insertion_sort", "keys", true, [](input &in, auto&) {
+    auto v = in.keys;
+    sort::insertion_sort(v);
+  }));
+  cs.push_back(make_case("sort::heap_sort", "keys", false, [](input &in, auto&) {
+    auto v = in.keys;
+    sort::heap_sort(v);
+  }));
+  cs.push_back(make_case("sort::merge_sort", "keys", false, [](input &in, auto&) {
+    auto v = in.keys;
+    sort::merge_sort(v);
+  }));
+  cs.push_back(make_case("sort::parallel_merge_sort", "keys", false, [](input &in, auto&) {
+    auto v = in.keys;
+    sort::parallel_merge_sort(v);
+  }));
+  cs.push_back(make_case("sort::radix_sort", "keys", false, [](input &in, auto&) {
+    auto v = in.keys;
+    sort::radix_sort(v);
+  }));
+  cs.push_back(make_case("std::sort", "keys", false, [](input &in, auto&) {
+    auto v = in.keys;
+    std::sort(v.begin(), v.end());
+  }));
+  return cs;
+}
+
+// Run [c] [reps] times in a child process and print its result.
+void run_case(const bench_case &c, input &in, const options &opts) {
+  cout.flush();
+  const long input_rss = rss_kb();
+  const uint64_t work = in.keys.empty() ? in.num_edges : in.keys.size();
+  const uint64_t vertices = in.keys.empty() ? in.g.num_vertices() : 0;
+
+  stringstream prefix;
+  prefix << "{\"case\": \"" << c.name << "\", \"input\": \"" << in.name
+         << "\", \"size\": " << in.size << ", \"vertices\": " << vertices
+         << ", \"edges\": " << in.num_edges;
+
+  if (c.quadratic && in.size > opts.quadratic_max) {
+    cout << prefix.str() << ", \"skipped\": true}" << endl;
+    return;
+  }
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    double best = numeric_limits<double>::max();
+    double total = 0;
+    for (uint r = 0; r < opts.reps; r++) {
+      const auto start = chrono::steady_clock::now();
+      try {
+        c.run(in);
+      } catch (const invalid_argument &e) {
+        cout << prefix.str() << ", \"error\": \"" << e.what() << "\"}" << endl;
+        _exit(0);
+      }
+      const chrono::duration<double> t = chrono::steady_clock::now() - start;
+      best = min(best, t.count());
+      total += t.count();
+    }
+    cout << prefix.str() << ", \"reps\": " << opts.reps
+         << ", \"time_s\": " << best
+         << ", \"mean_s\": " << total / opts.reps
+         << ", \"edges_per_sec\": " << work / best
+         << ", \"peak_rss_kb\": " << peak_rss_kb()
+         << ", \"input_rss_kb\": " << input_rss;
+    if (opts.counters) {
+      // One more (untimed) run to collect operation counts.
+      instrument::stats st;
+      c.count(in, st);
+      cout << ", \"counters\": {\"settled\": " << st.settled
+           << ", \"relaxed\": " << st.relaxed
+           << ", \"heap_inserts\": " << st.heap_inserts
+           << ", \"decrease_keys\": " << st.decrease_keys
+           << ", \"extracts\": " << st.extracts
+           << ", \"uf_finds\": " << st.uf_finds
+           << ", \"uf_path_length\": " << st.uf_path_length
+           << ", \"bytes_allocated\": " << st.bytes_allocated << "}";
+    }
+    cout << "}" << endl;
+    _exit(0);
+  }
+
+  int status;
+  waitpid(pid, &status, 0);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    cout << prefix.str() << ", \"error\": \"child exited abnormally\"}" << endl;
+  }
+}
+
+vector<uint> parse_sizes(const string &s) {
+  vector<uint> sizes;
+  for (const auto &x : split(s, ',')) {
+    sizes.push_back(stod(x));
+  }
+  return sizes;
+}
+
+int main(int argc, char **argv) {
+  options opts;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const string flag = argv[i];
+    const string value = argv[i+1];
+    if (flag == "--sizes") {
+      opts.sizes = parse_sizes(value);
+    } else if (flag == "--max-size") {
+      opts.max_size = stod(value);
+    } else if (flag == "--quadratic-max") {
+      opts.quadratic_max = stod(value);
+    } else if (flag == "--reps") {
+      opts.reps = stoi(value);
+    } else if (flag == "--filter") {
+      opts.filter = value;
+    } else if (flag == "--seed") {
+      opts.seed = stoi(value);
+    } else if (flag == "--counters") {
+      opts.counters = value == "1" || value == "true";
+    } else {
+      cerr << "unknown flag " << flag << endl;
+      return 1;
+    }
+  }
+
+  const auto cs = cases();
+
+  // Run all selected cases on input [in].
+  auto run_all = [&](input &in) {
+    in.num_edges = count_edges(in.g);
+    for (const auto &c : cs) {
+      if (c.family != in.name || c.name.find(opts.filter) == string::npos) {
+        continue;
+      }
+      if (c.name.ends_with("/compact") && !in.compact.has_value()) {
+        in.compact.emplace(in.g);
+      }
+      if (c.name.ends_with("/compressed") && !in.compressed.has_value()) {
+        in.compressed.emplace(in.g);
+      }
+      if (c.name.ends_with("/rcm") && !in.rcm.has_value()) {
+        const auto p = reorder::rcm(in.g);
+        in.rcm.emplace(reorder::relabel_compact<int>(in.g, p));
+        in.rcm_src = p.index(in.src);
+        in.rcm_dest = p.index(in.dest);
+      }
+      if (c.name.ends_with("/dense") && !in.dense.has_value()) {
+        in.dense.emplace(in.g);
+      }
+      if (c.name.ends_with("/alt") && !in.alt) {
+        in.alt = make_shared<alt_landmarks<int, int>>(in.g, 16);
+      }
+      // The external cases read a CSR file in the temp directory (hot
+      // in the page cache, so they measure the scans, not the disk).
+      // The mapping outlives the file.
+      if (c.name.starts_with("external::") && !in.external) {
+        const auto path = filesystem::temp_directory_path() /
+          ("bench-" + to_string(getpid()) + ".csr");
+        external::write(in.g, path);
+        in.external = make_shared<csr_file<int, int>>(path);
+        filesystem::remove(path);
+      }
+    }
+    for (const auto &c : cs) {
+      if (c.family == in.name && c.name.find(opts.filter) != string::npos) {
+        run_case(c, in, opts);
+      }
+    }
+  };
+
+  // Whether any selected case runs on input family [family] (to
+  // avoid building inputs for nothing).
+  auto wanted = [&](const string &family) {
+    for (const auto &c : cs) {
+      if (c.family == family && c.name.find(opts.filter) != string::npos) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  for (const auto &load : {load_pe83, load_pe107}) {
+    if (auto in = load(); in.has_value() && wanted(in->name)) {
+      run_all(in.value());
+    }
+  }
+
+  const vector<pair<string, function<input(uint, uint)>>> families{
+    {"grid", make_grid}, {"random", make_random}, {"rmat", make_rmat},
+    {"geometric", make_geometric}, {"dag", make_dag}, {"keys", make_keys}
+  };
+  for (const auto n : opts.sizes) {
+    if (n > opts.max_size) {
+      continue;
+    }
+    for (const auto &[family, make] : families) {
+      if (wanted(family)) {
+        input in = make(n, opts.seed);
+        run_all(in);
+      }
+    }
+  }
+}
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <memory_resource>
 #include <unordered_map>
 #include <vector>
 
@@ -9,6 +10,10 @@ template <typename K, std::totally_ordered V>
 class binary_heap {
 public:
 
+  binary_heap() : binary_heap(std::pmr::get_default_resource()) {}
+
+  explicit binary_heap(std::pmr::memory_resource *mr) : _heap(mr), _ixs(mr) {}
+
   // Insert a key/value pair into the heap.
   void insert(const K &k, const V &v) {
     if (!this->contains(k)) {
@@ -26,8 +31,10 @@ public:
     this->_heap[0] = this->_heap.back();
     this->_heap.pop_back();
     this->_ixs.erase(root.first);
-    this->_ixs[this->_heap[0].first] = 0;
-    this->_heapify_down(0);
+    if (!this->_heap.empty()) {
+      this->_ixs[this->_heap[0].first] = 0;
+      this->_heapify_down(0);
+    }
     return root;
   }
 
@@ -43,13 +50,13 @@ public:
     return this->_heap.size();
   }
 
-  constexpr bool contains(const K &k) {
+  constexpr bool contains(const K &k) const {
     return this->_ixs.contains(k);
   }
 
 private:
-  std::vector<std::pair<K, V>> _heap;
-  std::unordered_map<K, uint> _ixs;
+  std::pmr::vector<std::pair<K, V>> _heap;
+  std::pmr::unordered_map<K, uint> _ixs;
 
   void _swap(uint i, uint j) {
     this->_ixs[this->_heap[i].first] = j;
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <ranges>
+#include <type_traits>
 #include <vector>
 
 #include "graph.h"
@@ -12,41 +19,96 @@ namespace common {
   template <typename T>
   concept Numeric = std::integral<T> || std::floating_point<T>;
 
-  template <typename T>
-  constexpr bool contains(const std::vector<T> &v, const T &x) {
+  // Vertex, label and edge types of graph type [G].
+  template <typename G>
+  using vertex_t = typename G::vertex_type;
+
+  template <typename G>
+  using label_t = typename G::label_type;
+
+  template <typename G>
+  using edge_t = edge<vertex_t<G>, label_t<G>>;
+
+  // Interface the algorithms need from a graph, so they work on both
+  // 'graph' and read-only representations like 'compact_graph' (see
+  // compact_graph.h). 'out_edges' may produce the edges by value.
+  template <typename G>
+  concept Graph = requires(const G &g, const vertex_t<G> &v) {
+    { g.vertex_view() } -> std::ranges::forward_range;
+    { g.out_edges(v) } -> std::ranges::forward_range;
+    requires std::same_as<std::ranges::range_value_t<decltype(g.out_edges(v))>,
+                          edge_t<G>>;
+    { g.num_vertices() } -> std::convertible_to<uint>;
+    { g.contains(v) } -> std::convertible_to<bool>;
+  };
+
+  // Graph with numeric edge labels (weights).
+  template <typename G>
+  concept WeightedGraph = Graph<G> && Numeric<label_t<G>>;
+
+  template <typename T, typename A>
+  constexpr bool contains(const std::vector<T, A> &v, const T &x) {
     return std::find(v.begin(), v.end(), x) != v.end();
   }
 
   // Argmin of vector [v] wrt. given score function [f]. I.e, [minᵢ(f(v[i]))].
-  template <typename T, Numeric N>
-  uint min_index(const std::vector<T> &v, std::function<N(const T&)> f) {
+  // [f] is called once per element (0 is returned when [v] is empty).
+  template <typename T, typename A, typename F>
+  requires Numeric<std::invoke_result_t<F&, const T&>>
+  uint min_index(const std::vector<T, A> &v, F &&f) {
     uint min_i = 0;
-    uint min = std::numeric_limits<T>::max();
-    for (uint i = 0; i < v.size(); i++) {
-      if (f(v[i]) < min) {
+    if (v.empty()) {
+      return min_i;
+    }
+    auto min = f(v[0]);
+    for (uint i = 1; i < v.size(); i++) {
+      const auto x = f(v[i]);
+      if (x < min) {
         min_i = i;
-        min = f(v[i]);
+        min = x;
       }
     }
     return min_i;
   }
 
+  // Predecessor of [v] in [pred], or null if it has none. [pred] is
+  // either a map from V to V (e.g., std::pmr::unordered_map<V, V>) or,
+  // for integral vertices, a vector indexed by vertex holding the
+  // vertex itself for "none".
+  template <typename Map, typename V>
+  const V *predecessor(const Map &pred, const V &v) {
+    if constexpr (requires { pred.find(v) == pred.end(); }) {
+      auto it = pred.find(v);
+      return it == pred.end() ? nullptr : &it->second;
+    } else {
+      if (v < 0 || static_cast<std::size_t>(v) >= pred.size() || pred[v] == v) {
+        return nullptr;
+      }
+      return &pred[v];
+    }
+  }
+
   // Build path (vector of unlabeled edges) in [g] from [src] to
-  // [dest] using given predecessors map [pred].
-  template <typename V, typename E>
-  std::vector<edge<V, E>> build_path(const graph<V, E> &g,
-                                     std::unordered_map<V, V> &pred,
-                                     const V &src,
-                                     const V &dest) {
-    std::vector<edge<V, E>> path;
-
-    V cur = dest;
-    while (pred.contains(cur)) {
-      path.push_back({pred.at(cur), cur, {}});
-      cur = pred.at(cur);
+  // [dest] using given predecessors [pred] (see 'predecessor'). The
+  // path is measured first and then filled in from the end, so it
+  // comes out in order with one lookup per vertex per pass. See
+  // path.h for paths with their distance and labels on demand.
+  template <Graph G, typename Map>
+  std::vector<edge_t<G>> build_path(const G &g,
+                                    const Map &pred,
+                                    const vertex_t<G> &src,
+                                    const vertex_t<G> &dest) {
+    std::size_t n = 0;
+    for (auto p = predecessor(pred, dest); p; p = predecessor(pred, *p)) {
+      n++;
     }
 
-    std::reverse(path.begin(), path.end());
+    std::vector<edge_t<G>> path(n);
+    vertex_t<G> cur = dest;
+    for (auto p = predecessor(pred, dest); p; p = predecessor(pred, *p)) {
+      path[--n] = {*p, cur, {}};
+      cur = *p;
+    }
 
     return path;
   }
@@ -0,0 +1,238 @@
+// Compact, read-only graph representation (compressed sparse rows,
+// structure of arrays). The vertices are numbered 0 to n-1, and the
+// out-edges of each vertex are stored contiguously as two parallel
+// arrays of target indices and weights, with an array of offsets
+// marking where each vertex's edges begin. Unlike 'graph', which
+// stores a full 'edge' (source, target and label) per adjacency
+// entry, only the targets and weights are stored, and their types
+// can be narrowed at compile time: e.g., a compact_graph<int, int,
+// uint32_t, uint16_t> takes 6 bytes per edge instead of 12. 'edge'
+// objects are only materialized by 'out_edges', so all the
+// algorithms written against common::Graph work on it unchanged;
+// performance-critical code can use the index interface instead.
+//
+// When the vertices are exactly the integers 0 to n-1, vertex labels
+// are their own indices and no mapping is stored.
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "common.h"
+#include "graph.h"
+
+template <typename V, typename E,
+          std::unsigned_integral Index = uint32_t,
+          typename Weight = E>
+class compact_graph {
+public:
+  using vertex_type = V;
+  using label_type = E;
+  using index_type = Index;
+  using weight_type = Weight;
+
+  // Compact copy of [g]. Throws if it has too many vertices for
+  // 'Index' or a label that 'Weight' can't represent exactly.
+  explicit compact_graph(const graph<V, E> &g,
+                         std::pmr::memory_resource *mr =
+                         std::pmr::get_default_resource())
+    : _offsets(mr), _targets(mr), _weights(mr), _labels(mr), _ixs(mr) {
+    auto vs = g.vertex_view();
+    this->_set_vertices(std::vector<V>(vs.begin(), vs.end()));
+
+    const uint64_t n = this->num_vertices();
+    this->_offsets.resize(n + 1);
+    for (Index i = 0; i < n; i++) {
+      this->_offsets[i + 1] = this->_offsets[i] + g.out_edges(this->label(i)).size();
+    }
+    this->_targets.resize(this->_offsets[n]);
+    this->_weights.resize(this->_offsets[n]);
+    for (Index i = 0; i < n; i++) {
+      uint64_t j = this->_offsets[i];
+      for (const auto &e : g.out_edges(this->label(i))) {
+        this->_set_edge(j++, e);
+      }
+    }
+  }
+
+  // Graph with vertices [vs] and (directed) edges [es].
+  compact_graph(std::span<const V> vs,
+                std::span<const edge<V, E>> es,
+                std::pmr::memory_resource *mr =
+                std::pmr::get_default_resource())
+    : _offsets(mr), _targets(mr), _weights(mr), _labels(mr), _ixs(mr) {
+    this->_set_vertices(std::vector<V>(vs.begin(), vs.end()));
+
+    // Counting sort of the edges by source.
+    const uint64_t n = this->num_vertices();
+    this->_offsets.assign(n + 1, 0);
+    std::vector<Index> sources(es.size());
+    for (uint64_t k = 0; k < es.size(); k++) {
+      sources[k] = this->index(es[k].v1);
+      this->_offsets[sources[k] + 1]++;
+    }
+    for (Index i = 0; i < n; i++) {
+      this->_offsets[i + 1] += this->_offsets[i];
+    }
+    std::vector<uint64_t> next(this->_offsets.begin(), this->_offsets.end() - 1);
+    this->_targets.resize(es.size());
+    this->_weights.resize(es.size());
+    for (uint64_t k = 0; k < es.size(); k++) {
+      this->_set_edge(next[sources[k]]++, es[k]);
+    }
+  }
+
+  // Graph interface (see common::Graph).
+
+  auto vertex_view() const {
+    return std::views::iota(Index{0}, static_cast<Index>(this->num_vertices())) |
+      std::views::transform([this](Index i) { return this->label(i); });
+  }
+
+  constexpr uint num_vertices() const {
+    return this->_offsets.size() - 1;
+  }
+
+  constexpr uint64_t num_edges() const {
+    return this->_targets.size();
+  }
+
+  bool contains(const V &v) const {
+    if (this->_identity) {
+      if constexpr (std::integral<V>) {
+        return 0 <= v && static_cast<uint64_t>(v) < this->num_vertices();
+      }
+    }
+    return this->_ixs.contains(v);
+  }
+
+  // View of the edges out of [v], materialized on the fly.
+  auto out_edges(const V &v) const {
+    const Index i = this->index(v);
+    return std::views::iota(this->_offsets[i], this->_offsets[i + 1]) |
+      std::views::transform([this, v](uint64_t j) {
+        return edge<V, E>{v, this->label(this->_targets[j]),
+                          static_cast<E>(this->_weights[j])};
+      });
+  }
+
+  std::vector<edge<V, E>> edges(const V &v) const {
+    auto es = this->out_edges(v);
+    return std::vector<edge<V, E>>(es.begin(), es.end());
+  }
+
+  std::vector<edge<V, E>> all_edges() const {
+    std::vector<edge<V, E>> es;
+    es.reserve(this->num_edges());
+    for (const auto &v : this->vertex_view()) {
+      for (const auto &e : this->out_edges(v)) {
+        es.push_back(e);
+      }
+    }
+    return es;
+  }
+
+  uint out_degree(const V &v) const {
+    return this->degree(this->index(v));
+  }
+
+  // Index interface.
+
+  // Index of vertex [v] (throws if it doesn't exist).
+  Index index(const V &v) const {
+    if (this->_identity) {
+      if constexpr (std::integral<V>) {
+        if (this->contains(v)) {
+          return static_cast<Index>(v);
+        }
+        throw std::invalid_argument("vertex not in graph");
+      }
+    }
+    if (auto it = this->_ixs.find(v); it != this->_ixs.end()) {
+      return it->second;
+    }
+    throw std::invalid_argument("vertex not in graph");
+  }
+
+  // Vertex with index [i].
+  V label(Index i) const {
+    if constexpr (std::integral<V>) {
+      if (this->_identity) {
+        return static_cast<V>(i);
+      }
+    }
+    return this->_labels[i];
+  }
+
+  uint degree(Index i) const {
+    return this->_offsets[i + 1] - this->_offsets[i];
+  }
+
+  // Target indices and weights of the edges out of vertex [i].
+  std::span<const Index> targets(Index i) const {
+    return {this->_targets.data() + this->_offsets[i], this->degree(i)};
+  }
+
+  std::span<const Weight> weights(Index i) const {
+    return {this->_weights.data() + this->_offsets[i], this->degree(i)};
+  }
+
+  // Bytes of storage used (not counting the vertex label mapping).
+  uint64_t bytes() const {
+    return this->_offsets.size() * sizeof(uint64_t) +
+      this->_targets.size() * sizeof(Index) +
+      this->_weights.size() * sizeof(Weight);
+  }
+
+private:
+  std::pmr::vector<uint64_t> _offsets;
+  std::pmr::vector<Index> _targets;
+  std::pmr::vector<Weight> _weights;
+
+  // Vertex labels, unless they're the same as the indices.
+  bool _identity = false;
+  std::pmr::vector<V> _labels;
+  std::pmr::unordered_map<V, Index> _ixs;
+
+  // Every index and the vertex count itself must fit in 'Index' (and
+  // the count in 'num_vertices'), so there can be at most max(Index)
+  // vertices.
+  void _set_vertices(std::vector<V> vs) {
+    if (vs.size() > std::min<uint64_t>(std::numeric_limits<Index>::max(),
+                                       std::numeric_limits<uint>::max())) {
+      throw std::invalid_argument("too many vertices for index type");
+    }
+    if constexpr (std::totally_ordered<V>) {
+      std::sort(vs.begin(), vs.end());
+    }
+    if constexpr (std::integral<V>) {
+      this->_identity = std::ranges::equal(vs, std::views::iota(V{0}, static_cast<V>(vs.size())));
+    }
+    this->_offsets.assign(vs.size() + 1, 0);
+    if (!this->_identity) {
+      this->_ixs.reserve(vs.size());
+      for (uint64_t i = 0; i < vs.size(); i++) {
+        this->_ixs[vs[i]] = static_cast<Index>(i);
+      }
+      this->_labels.assign(vs.begin(), vs.end());
+    }
+  }
+
+  void _set_edge(uint64_t j, const edge<V, E> &e) {
+    const Weight w = static_cast<Weight>(e.label);
+    if (static_cast<E>(w) != e.label) {
+      throw std::invalid_argument("label doesn't fit weight type");
+    }
+    this->_targets[j] = this->index(e.v2);
+    this->_weights[j] = w;
+  }
+};
@@ -0,0 +1,468 @@
+// Compressed, read-only graph representation, for graphs too large to
+// fit in memory even as a compact_graph (see compact_graph.h). The
+// vertices are numbered 0 to n-1 as in compact_graph, and each
+// vertex's out-edges are sorted by target and stored as a byte string:
+//
+//   degree, bytes of edges (LEB128, the latter only if degree > 0),
+//   then per group of up to 4 edges:
+//     target gaps (Stream VByte, see varint.h),
+//     weights (Stream VByte, zigzag encoded if signed; or raw bytes
+//              for floating point weights)
+//
+// The first target is stored relative to the source (zigzag encoded)
+// and the others as the gap from the previous target, so graphs whose
+// edges mostly join nearby indices (e.g., after reorder::rcm) compress
+// best. Targets typically take 2-3 bytes per edge, control bytes and
+// headers included; with weights below 2^14, the benchmark graphs take
+// 4-5 bytes per edge in all, against 9-10 as a compact_graph and 12
+// or more as a 'graph'.
+//
+// The byte strings of consecutive vertices are concatenated, and the
+// offset of every 'block_size'-th one is kept, so finding a vertex's
+// edges means skipping (by their byte lengths) at most block_size - 1
+// vertices before it. Edges are decoded a group at a time as they are
+// iterated, so nothing is materialized: 'out_edges' produces 'edge'
+// objects for the algorithms written against common::Graph, and
+// 'targets' just the target indices for index-based code like
+// msbfs.h, without decoding the weights.
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+#include "graph.h"
+#include "varint.h"
+
+template <typename V, typename E, typename Weight = E>
+  requires (std::integral<Weight> && sizeof(Weight) <= 4) || std::floating_point<Weight>
+class compressed_graph {
+public:
+  using vertex_type = V;
+  using label_type = E;
+  using index_type = uint32_t;
+  using weight_type = Weight;
+
+  // Vertices per stored offset.
+  static constexpr uint block_size = 16;
+
+  // An out-edge, by target index.
+  struct entry {
+    uint32_t target;
+    Weight weight;
+  };
+
+  // Compressed copy of [g]. Throws if it has too many vertices or a
+  // label that 'Weight' can't represent exactly.
+  explicit compressed_graph(const graph<V, E> &g,
+                            std::pmr::memory_resource *mr =
+                            std::pmr::get_default_resource())
+    : _blocks(mr), _data(mr), _labels(mr), _ixs(mr) {
+    auto vs = g.vertex_view();
+    this->_set_vertices(std::vector<V>(vs.begin(), vs.end()));
+
+    std::vector<entry> es;
+    std::vector<uint8_t> buf;
+    for (uint32_t i = 0; i < this->num_vertices(); i++) {
+      es.clear();
+      for (const auto &e : g.out_edges(this->label(i))) {
+        es.push_back(this->_entry(e));
+      }
+      this->_append(i, es, buf);
+    }
+    this->_finish();
+  }
+
+  // Graph with vertices [vs] and (directed) edges [es].
+  compressed_graph(std::span<const V> vs,
+                   std::span<const edge<V, E>> es,
+                   std::pmr::memory_resource *mr =
+                   std::pmr::get_default_resource())
+    : _blocks(mr), _data(mr), _labels(mr), _ixs(mr) {
+    this->_set_vertices(std::vector<V>(vs.begin(), vs.end()));
+
+    // Counting sort of the edges by source.
+    const uint32_t n = this->num_vertices();
+    std::vector<uint64_t> offsets(n + 1, 0);
+    std::vector<uint32_t> sources(es.size());
+    for (uint64_t k = 0; k < es.size(); k++) {
+      sources[k] = this->index(es[k].v1);
+      offsets[sources[k] + 1]++;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+      offsets[i + 1] += offsets[i];
+    }
+    std::vector<entry> sorted(es.size());
+    {
+      std::vector<uint64_t> next(offsets.begin(), offsets.end() - 1);
+      for (uint64_t k = 0; k < es.size(); k++) {
+        sorted[next[sources[k]]++] = this->_entry(es[k]);
+      }
+    }
+    sources = {};
+
+    std::vector<entry> out;
+    std::vector<uint8_t> buf;
+    for (uint32_t i = 0; i < n; i++) {
+      out.assign(sorted.begin() + offsets[i], sorted.begin() + offsets[i + 1]);
+      this->_append(i, out, buf);
+    }
+    this->_finish();
+  }
+
+  // Graph interface (see common::Graph).
+
+  auto vertex_view() const {
+    return std::views::iota(uint32_t{0}, this->num_vertices()) |
+      std::views::transform([this](uint32_t i) { return this->label(i); });
+  }
+
+  constexpr uint num_vertices() const {
+    return this->_n;
+  }
+
+  constexpr uint64_t num_edges() const {
+    return this->_m;
+  }
+
+  bool contains(const V &v) const {
+    if (this->_identity) {
+      if constexpr (std::integral<V>) {
+        return 0 <= v && static_cast<uint64_t>(v) < this->num_vertices();
+      }
+    }
+    return this->_ixs.contains(v);
+  }
+
+  // View of the edges out of [v], decoded on the fly.
+  auto out_edges(const V &v) const {
+    return this->adjacency(this->index(v)) |
+      std::views::transform([this, v](const entry &e) {
+        return edge<V, E>{v, this->label(e.target), static_cast<E>(e.weight)};
+      });
+  }
+
+  std::vector<edge<V, E>> edges(const V &v) const {
+    auto es = this->out_edges(v);
+    return std::vector<edge<V, E>>(es.begin(), es.end());
+  }
+
+  std::vector<edge<V, E>> all_edges() const {
+    std::vector<edge<V, E>> es;
+    es.reserve(this->num_edges());
+    for (const auto &v : this->vertex_view()) {
+      for (const auto &e : this->out_edges(v)) {
+        es.push_back(e);
+      }
+    }
+    return es;
+  }
+
+  uint out_degree(const V &v) const {
+    return this->degree(this->index(v));
+  }
+
+  // Index interface (as in compact_graph, but edges are ranges of
+  // decoded entries instead of spans).
+
+  // Index of vertex [v] (throws if it doesn't exist).
+  uint32_t index(const V &v) const {
+    if (this->_identity) {
+      if constexpr (std::integral<V>) {
+        if (this->contains(v)) {
+          return static_cast<uint32_t>(v);
+        }
+        throw std::invalid_argument("vertex not in graph");
+      }
+    }
+    if (auto it = this->_ixs.find(v); it != this->_ixs.end()) {
+      return it->second;
+    }
+    throw std::invalid_argument("vertex not in graph");
+  }
+
+  // Vertex with index [i].
+  V label(uint32_t i) const {
+    if constexpr (std::integral<V>) {
+      if (this->_identity) {
+        return static_cast<V>(i);
+      }
+    }
+    return this->_labels[i];
+  }
+
+  uint degree(uint32_t i) const {
+    return this->_locate(i).second;
+  }
+
+private:
+  // Forward iterator decoding a vertex's edges a group at a time,
+  // yielding entries, or just the target indices (skipping over the
+  // weights) if not [Weights].
+  template <bool Weights>
+  class _iterator {
+  public:
+    using value_type = std::conditional_t<Weights, entry, uint32_t>;
+    using difference_type = std::ptrdiff_t;
+
+    _iterator() {}
+
+    _iterator(const uint8_t *p, uint32_t degree, uint32_t source)
+      : _p(p), _left(degree), _prev(source) {
+      this->_fill();
+    }
+
+    value_type operator*() const {
+      if constexpr (Weights) {
+        return {this->_targets[this->_k], this->_weights[this->_k]};
+      } else {
+        return this->_targets[this->_k];
+      }
+    }
+
+    _iterator &operator++() {
+      if (++this->_k == this->_count) {
+        this->_fill();
+      }
+      return *this;
+    }
+
+    _iterator operator++(int) {
+      _iterator it = *this;
+      ++*this;
+      return it;
+    }
+
+    // Iterators over the same edges are equal if they have as many
+    // edges left (so the end is any iterator with none).
+    bool operator==(const _iterator &other) const {
+      return this->_left + (this->_count - this->_k) ==
+        other._left + (other._count - other._k);
+    }
+
+  private:
+    const uint8_t *_p = nullptr; // Next group.
+    uint32_t _left = 0;          // Edges in the groups after this one.
+    uint32_t _prev = 0;          // Last target decoded (or the source).
+    bool _first = true;
+    uint8_t _k = 0, _count = 0;
+    uint32_t _targets[4];
+    [[no_unique_address]] std::conditional_t<Weights, Weight[4], std::tuple<>> _weights;
+
+    // Decode the next group.
+    void _fill() {
+      this->_k = 0;
+      this->_count = std::min<uint32_t>(4, this->_left);
+      if (this->_count == 0) {
+        return;
+      }
+      this->_left -= this->_count;
+
+      uint8_t ctrl = *this->_p++;
+      varint::decode(this->_p, ctrl, this->_targets);
+      this->_p += varint::group_bytes(ctrl, this->_count);
+      uint32_t t = this->_prev;
+      for (uint k = 0; k < this->_count; k++) {
+        if (this->_first) {
+          t += varint::unzigzag(this->_targets[0]);
+          this->_first = false;
+        } else {
+          t += this->_targets[k];
+        }
+        this->_targets[k] = t;
+      }
+      this->_prev = t;
+
+      if constexpr (std::floating_point<Weight>) {
+        if constexpr (Weights) {
+          std::memcpy(this->_weights, this->_p, this->_count * sizeof(Weight));
+        }
+        this->_p += this->_count * sizeof(Weight);
+      } else {
+        ctrl = *this->_p++;
+        if constexpr (Weights) {
+          uint32_t ws[4];
+          varint::decode(this->_p, ctrl, ws);
+          for (uint k = 0; k < this->_count; k++) {
+            this->_weights[k] = _decode_weight(ws[k]);
+          }
+        }
+        this->_p += varint::group_bytes(ctrl, this->_count);
+      }
+    }
+  };
+
+  template <bool Weights>
+  class _range : public std::ranges::view_interface<_range<Weights>> {
+  public:
+    _range() {}
+
+    _range(const uint8_t *p, uint32_t degree, uint32_t source)
+      : _p(p), _degree(degree), _source(source) {}
+
+    _iterator<Weights> begin() const {
+      return _iterator<Weights>(this->_p, this->_degree, this->_source);
+    }
+
+    _iterator<Weights> end() const {
+      return _iterator<Weights>();
+    }
+
+  private:
+    const uint8_t *_p = nullptr;
+    uint32_t _degree = 0;
+    uint32_t _source = 0;
+  };
+
+public:
+  // Edges out of vertex [i], as entries.
+  _range<true> adjacency(uint32_t i) const {
+    const auto [p, d] = this->_locate(i);
+    return {p, d, i};
+  }
+
+  // Target indices of the edges out of vertex [i].
+  _range<false> targets(uint32_t i) const {
+    const auto [p, d] = this->_locate(i);
+    return {p, d, i};
+  }
+
+  // Bytes of storage used (not counting the vertex label mapping).
+  uint64_t bytes() const {
+    return this->_blocks.size() * sizeof(uint64_t) + this->_data.size();
+  }
+
+private:
+  uint32_t _n = 0;
+  uint64_t _m = 0;
+  std::pmr::vector<uint64_t> _blocks; // Offset of every block_size-th vertex.
+  std::pmr::vector<uint8_t> _data;
+
+  // Vertex labels, unless they're the same as the indices.
+  bool _identity = false;
+  std::pmr::vector<V> _labels;
+  std::pmr::unordered_map<V, uint32_t> _ixs;
+
+  static uint32_t _encode_weight(Weight w) {
+    if constexpr (std::signed_integral<Weight>) {
+      return varint::zigzag(w);
+    } else {
+      return w;
+    }
+  }
+
+  static Weight _decode_weight(uint32_t x) {
+    if constexpr (std::signed_integral<Weight>) {
+      return static_cast<Weight>(varint::unzigzag(x));
+    } else {
+      return static_cast<Weight>(x);
+    }
+  }
+
+  void _set_vertices(std::vector<V> vs) {
+    // Below 2^31 so that target - source fits in 32 bits zigzagged.
+    if (vs.size() > static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+      throw std::invalid_argument("too many vertices for index type");
+    }
+    if constexpr (std::totally_ordered<V>) {
+      std::sort(vs.begin(), vs.end());
+    }
+    if constexpr (std::integral<V>) {
+      this->_identity = std::ranges::equal(vs, std::views::iota(V{0}, static_cast<V>(vs.size())));
+    }
+    this->_n = vs.size();
+    if (!this->_identity) {
+      this->_ixs.reserve(vs.size());
+      for (uint64_t i = 0; i < vs.size(); i++) {
+        this->_ixs[vs[i]] = static_cast<uint32_t>(i);
+      }
+      this->_labels.assign(vs.begin(), vs.end());
+    }
+  }
+
+  entry _entry(const edge<V, E> &e) const {
+    const Weight w = static_cast<Weight>(e.label);
+    if (static_cast<E>(w) != e.label) {
+      throw std::invalid_argument("label doesn't fit weight type");
+    }
+    return {this->index(e.v2), w};
+  }
+
+  // Append the edges [es] of vertex [i] (which must be the next one),
+  // using [buf] as scratch space.
+  void _append(uint32_t i, std::vector<entry> &es, std::vector<uint8_t> &buf) {
+    if (i % block_size == 0) {
+      this->_blocks.push_back(this->_data.size());
+    }
+    std::sort(es.begin(), es.end(), [](const entry &a, const entry &b) {
+      return a.target < b.target || (a.target == b.target && a.weight < b.weight);
+    });
+
+    buf.clear();
+    uint32_t prev = i;
+    for (uint64_t k = 0; k < es.size(); k += 4) {
+      const uint count = std::min<uint64_t>(4, es.size() - k);
+      uint32_t xs[4];
+      for (uint j = 0; j < count; j++) {
+        const uint32_t t = es[k + j].target;
+        xs[j] = k + j == 0 ? varint::zigzag(static_cast<int32_t>(t - prev)) : t - prev;
+        prev = t;
+      }
+      varint::encode(buf, xs, count);
+      if constexpr (std::floating_point<Weight>) {
+        for (uint j = 0; j < count; j++) {
+          const auto *w = reinterpret_cast<const uint8_t*>(&es[k + j].weight);
+          buf.insert(buf.end(), w, w + sizeof(Weight));
+        }
+      } else {
+        for (uint j = 0; j < count; j++) {
+          xs[j] = _encode_weight(es[k + j].weight);
+        }
+        varint::encode(buf, xs, count);
+      }
+    }
+
+    varint::put(this->_data, es.size());
+    if (!es.empty()) {
+      varint::put(this->_data, buf.size());
+    }
+    this->_data.insert(this->_data.end(), buf.begin(), buf.end());
+    this->_m += es.size();
+  }
+
+  void _finish() {
+    this->_data.resize(this->_data.size() + varint::slack);
+    this->_data.shrink_to_fit();
+    this->_blocks.shrink_to_fit();
+  }
+
+  // Start of the edges of vertex [i], and its degree.
+  std::pair<const uint8_t*, uint32_t> _locate(uint32_t i) const {
+    const uint8_t *p = this->_data.data() + this->_blocks[i / block_size];
+    for (uint32_t k = i - i % block_size; k < i; k++) {
+      if (varint::get(p) > 0) {
+        const uint64_t len = varint::get(p);
+        p += len;
+      }
+    }
+    const uint32_t d = varint::get(p);
+    if (d > 0) {
+      varint::get(p);
+    }
+    return {p, d};
+  }
+};
@@ -0,0 +1,315 @@
+// Versioned graph that can be queried while it's being updated. The
+// graph is a sequence of immutable versions ('epochs'). Writers
+// queue up mutations and 'commit' them, which applies them to a copy
+// of the latest version and publishes the copy as the next epoch.
+// Readers pin the latest version as a snapshot, which stays valid
+// and unchanged for as long as they hold it, and run the usual
+// algorithms on it:
+//
+//   concurrent_graph<int, int> cg;
+//   // Writer thread.
+//   cg.add_edge(u, v, w);
+//   ...
+//   cg.commit();
+//   // Each reader thread.
+//   auto r = cg.make_reader();
+//   auto snap = r.pin();
+//   auto path = dijkstra::shortest_path2(*snap, src, dest);
+//
+// Old versions are reclaimed with epoch-based reclamation: each
+// reader announces the epoch it's pinning in its own slot, and a
+// version is freed once it's been replaced and no reader announces
+// an epoch at or before it. Pinning is a couple of atomic loads and
+// stores, so readers never block (writers only ever wait for each
+// other). Since a commit copies the whole graph, its cost is linear
+// in the size of the graph -- mutations should be batched into
+// commits of thousands, not committed one at a time.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+
+template <typename V, typename E>
+class concurrent_graph {
+public:
+  // Maximum number of readers at any one time.
+  static constexpr uint max_readers = 64;
+
+private:
+  struct version {
+    graph<V, E> g;
+    uint64_t epoch;
+  };
+
+  // Reader slot, on its own cache line so readers don't contend.
+  struct alignas(64) slot {
+    std::atomic<bool> used = false;
+    std::atomic<uint64_t> epoch = 0; // 0 when not pinning anything.
+  };
+
+public:
+  // Pinned version of the graph. Unpins it when destroyed.
+  class snapshot {
+  public:
+    snapshot(const snapshot&) = delete;
+    snapshot &operator=(const snapshot&) = delete;
+
+    snapshot(snapshot &&other)
+      : _slot(std::exchange(other._slot, nullptr)), _version(other._version) {}
+
+    ~snapshot() {
+      if (this->_slot) {
+        this->_slot->epoch.store(0, std::memory_order_release);
+      }
+    }
+
+    const graph<V, E> &operator*() const {
+      return this->_version->g;
+    }
+
+    const graph<V, E> *operator->() const {
+      return &this->_version->g;
+    }
+
+    constexpr uint64_t epoch() const {
+      return this->_version->epoch;
+    }
+
+  private:
+    friend concurrent_graph;
+
+    snapshot(slot *s, const version *v) : _slot(s), _version(v) {}
+
+    slot *_slot;
+    const version *_version;
+  };
+
+  // Handle owning a reader slot. Each reading thread should make its
+  // own, and can pin one snapshot at a time with it.
+  class reader {
+  public:
+    reader(const reader&) = delete;
+    reader &operator=(const reader&) = delete;
+
+    reader(reader &&other)
+      : _cg(other._cg), _slot(std::exchange(other._slot, nullptr)) {}
+
+    ~reader() {
+      if (this->_slot) {
+        this->_slot->used.store(false, std::memory_order_release);
+      }
+    }
+
+    // Pin the latest version of the graph.
+    snapshot pin() {
+      if (this->_slot->epoch.load(std::memory_order_relaxed)) {
+        throw std::invalid_argument("reader already has a snapshot");
+      }
+      // Announce the current epoch, and check it's still current
+      // afterward. If it is, the writer will see our announcement
+      // before freeing anything we're about to load.
+      uint64_t e = this->_cg._epoch.load();
+      while (true) {
+        this->_slot->epoch.store(e);
+        const uint64_t e2 = this->_cg._epoch.load();
+        if (e == e2) {
+          break;
+        }
+        e = e2;
+      }
+      return snapshot(this->_slot, this->_cg._current.load());
+    }
+
+  private:
+    friend concurrent_graph;
+
+    reader(concurrent_graph &cg, slot *s) : _cg(cg), _slot(s) {}
+
+    concurrent_graph &_cg;
+    slot *_slot;
+  };
+
+  concurrent_graph() : concurrent_graph(graph<V, E>()) {}
+
+  // Start from (a copy of) [g] as epoch 1.
+  explicit concurrent_graph(const graph<V, E> &g)
+    : _current(new version{g, 1}), _epoch(1) {}
+
+  concurrent_graph(const concurrent_graph&) = delete;
+  concurrent_graph &operator=(const concurrent_graph&) = delete;
+
+  // All readers must be gone by now.
+  ~concurrent_graph() {
+    for (auto &[e, v] : this->_retired) {
+      delete v;
+    }
+    delete this->_current.load();
+  }
+
+  // Claim a reader slot (throws if all are taken).
+  reader make_reader() {
+    for (auto &s : this->_slots) {
+      bool expected = false;
+      if (!s.used.load(std::memory_order_relaxed) &&
+          s.used.compare_exchange_strong(expected, true)) {
+        return reader(*this, &s);
+      }
+    }
+    throw std::runtime_error("too many readers");
+  }
+
+  // The current epoch.
+  uint64_t epoch() const {
+    return this->_epoch.load();
+  }
+
+  // Queue mutations for the next commit. They're applied in the
+  // order they were made, like the corresponding 'graph' methods
+  // except that they never fail: adding an existing vertex does
+  // nothing, adding an edge adds its endpoints if necessary, and
+  // removing an edge between missing vertices does nothing.
+  void add_vertex(const V &v) {
+    std::lock_guard lock(this->_mutex);
+    this->_pending.push_back({op::add_vertex, {v, v, {}}, false});
+  }
+
+  void add_edge(const edge<V, E> &e, bool directed=false) {
+    std::lock_guard lock(this->_mutex);
+    this->_pending.push_back({op::add_edge, e, directed});
+  }
+
+  void add_edge(const V &v1, const V &v2, const E &lbl, bool directed=false) {
+    this->add_edge({v1, v2, lbl}, directed);
+  }
+
+  void remove_edge(const edge<V, E> &e, bool directed=false) {
+    std::lock_guard lock(this->_mutex);
+    this->_pending.push_back({op::remove_edge, e, directed});
+  }
+
+  // Number of mutations waiting for the next commit.
+  uint pending() {
+    std::lock_guard lock(this->_mutex);
+    return this->_pending.size();
+  }
+
+  // Apply the pending mutations and publish the result as a new
+  // epoch (returned). Does nothing when there are none.
+  uint64_t commit() {
+    std::lock_guard lock(this->_mutex);
+    if (this->_pending.empty()) {
+      return this->_epoch.load();
+    }
+    return this->_publish([this](graph<V, E> &g) {
+      for (const auto &m : this->_pending) {
+        switch (m.kind) {
+        case op::add_vertex:
+          _ensure_vertex(g, m.e.v1);
+          break;
+        case op::add_edge:
+          _ensure_vertex(g, m.e.v1);
+          _ensure_vertex(g, m.e.v2);
+          g.add_edge(m.e, m.directed);
+          break;
+        case op::remove_edge:
+          if (g.contains(m.e.v1) && g.contains(m.e.v2)) {
+            g.remove_edge(m.e, m.directed);
+          }
+          break;
+        }
+      }
+      this->_pending.clear();
+    });
+  }
+
+  // Apply arbitrary changes [f] (called with a mutable copy of the
+  // latest version, after any pending mutations) and publish the
+  // result as a new epoch (returned).
+  template <typename F>
+  uint64_t update(F &&f) {
+    this->commit();
+    std::lock_guard lock(this->_mutex);
+    return this->_publish(f);
+  }
+
+  // Free the replaced versions that no reader can see anymore (also
+  // done on every commit).
+  void reclaim() {
+    std::lock_guard lock(this->_mutex);
+    this->_reclaim();
+  }
+
+  // Number of replaced versions not yet freed.
+  uint retired() {
+    std::lock_guard lock(this->_mutex);
+    return this->_retired.size();
+  }
+
+private:
+  enum class op { add_vertex, add_edge, remove_edge };
+
+  struct mutation {
+    op kind;
+    edge<V, E> e;
+    bool directed;
+  };
+
+  std::atomic<version*> _current;
+  std::atomic<uint64_t> _epoch;
+  std::array<slot, max_readers> _slots;
+
+  // Writer state (guarded by '_mutex').
+  std::mutex _mutex;
+  std::vector<mutation> _pending;
+  std::vector<std::pair<uint64_t, version*>> _retired;
+
+  static void _ensure_vertex(graph<V, E> &g, const V &v) {
+    if (!g.contains(v)) {
+      g.add_vertex(v);
+    }
+  }
+
+  template <typename F>
+  uint64_t _publish(F &&f) {
+    version *old = this->_current.load();
+    version *next = new version{old->g, old->epoch + 1};
+    try {
+      f(next->g);
+    } catch (...) {
+      delete next;
+      throw;
+    }
+    // Publish the version before the epoch, so a reader announcing
+    // the new epoch is sure to load the new version.
+    this->_current.store(next);
+    this->_epoch.store(next->epoch);
+    this->_retired.push_back({old->epoch, old});
+    this->_reclaim();
+    return next->epoch;
+  }
+
+  void _reclaim() {
+    // Oldest epoch any reader might still be using.
+    uint64_t min = this->_epoch.load();
+    for (const auto &s : this->_slots) {
+      if (const uint64_t e = s.epoch.load(); e && e < min) {
+        min = e;
+      }
+    }
+    std::erase_if(this->_retired, [min](const auto &r) {
+      if (r.first < min) {
+        delete r.second;
+        return true;
+      }
+      return false;
+    });
+  }
+};
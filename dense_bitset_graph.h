@@ -0,0 +1,436 @@
+// Dense graph on vertices 0 to n-1, stored as an adjacency matrix of
+// bits: row v has bit u set when there's an edge v -> u. Edge labels
+// (weights) live in a separate n by n matrix. For small dense graphs
+// (like the 40-vertex network of PE#107) this is far more compact than
+// the hash-based 'graph', and traversals work on whole 64-bit words at
+// a time: a BFS level is the OR of the rows of the frontier minus the
+// visited set, the next DFS step is the lowest set bit of a row minus
+// the visited set, and so on.
+//
+// The number of vertices N can be fixed at compile time, in which case
+// all storage is inline (no allocations, which matters when analyzing
+// lots of small graphs), or std::dynamic_extent (the default) to
+// choose it at run time.
+//
+// Parallel edges aren't supported: adding an existing edge replaces
+// its label. It satisfies common::Graph, so the generic algorithms
+// run on it too.
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "graph.h"
+
+template <std::size_t N = std::dynamic_extent, typename E = int>
+class dense_bitset_graph {
+  static constexpr bool fixed = N != std::dynamic_extent;
+  static constexpr std::size_t fixed_words = fixed ? (N + 63) / 64 : 0;
+
+  // Inline array of M elements when N is fixed, vector otherwise.
+  template <typename T, std::size_t M>
+  using storage = std::conditional_t<fixed, std::array<T, M>, std::vector<T>>;
+
+public:
+  using vertex_type = uint;
+  using label_type = E;
+
+  // Set of vertices (one bit per vertex).
+  using mask = storage<uint64_t, fixed_words>;
+
+  // One value per vertex.
+  template <typename T>
+  using table = storage<T, fixed ? N : 0>;
+
+  dense_bitset_graph() requires fixed : _n(N), _words(fixed_words) {}
+
+  explicit dense_bitset_graph(uint n) requires (!fixed)
+    : _n(n), _words((n + 63) / 64), _rows(std::size_t{n} * this->_words, 0), _labels(std::size_t{n} * n) {}
+
+  // Copy of [g], whose vertices must be integers in [0, n) (where n is
+  // N if fixed, or the number of vertices of [g] otherwise).
+  template <std::integral V>
+  explicit dense_bitset_graph(const graph<V, E> &g)
+    : dense_bitset_graph(_make(g.num_vertices())) {
+    for (const auto &v : g.vertex_view()) {
+      if (v < 0 || static_cast<uint64_t>(v) >= this->_n) {
+        throw std::invalid_argument("vertex out of range");
+      }
+    }
+    for (const auto &v : g.vertex_view()) {
+      for (const auto &e : g.out_edges(v)) {
+        this->add_edge(e.v1, e.v2, e.label, true);
+      }
+    }
+  }
+
+  // Add edge [v1] -> [v2] with label [lbl] (and [v2] -> [v1] unless
+  // [directed]), replacing the label if it already exists.
+  void add_edge(uint v1, uint v2, const E &lbl, bool directed=false) {
+    this->_check(v1);
+    this->_check(v2);
+    this->_set(v1, v2, lbl);
+    if (!directed) {
+      this->_set(v2, v1, lbl);
+    }
+  }
+
+  void remove_edge(uint v1, uint v2, bool directed=false) {
+    this->_check(v1);
+    this->_check(v2);
+    this->_word(v1, v2) &= ~_bit(v2);
+    if (!directed) {
+      this->_word(v2, v1) &= ~_bit(v1);
+    }
+  }
+
+  bool has_edge(uint v1, uint v2) const {
+    return v1 < this->_n && v2 < this->_n && (this->_word(v1, v2) & _bit(v2));
+  }
+
+  // Label of edge [v1] -> [v2] (throws if there's no such edge).
+  const E &label(uint v1, uint v2) const {
+    if (!this->has_edge(v1, v2)) {
+      throw std::invalid_argument("edge not in graph");
+    }
+    return this->_labels[this->_cell(v1, v2)];
+  }
+
+  // Row of [v]: the set of its out-neighbors.
+  std::span<const uint64_t> row(uint v) const {
+    return {this->_rows.data() + std::size_t{v} * this->_words, this->_words};
+  }
+
+  // Graph interface (see common::Graph).
+
+  auto vertex_view() const {
+    return std::views::iota(0u, this->_n);
+  }
+
+  constexpr uint num_vertices() const {
+    return this->_n;
+  }
+
+  uint64_t num_edges() const {
+    uint64_t m = 0;
+    for (const uint64_t w : this->_rows) {
+      m += std::popcount(w);
+    }
+    return m;
+  }
+
+  constexpr bool contains(uint v) const {
+    return v < this->_n;
+  }
+
+  uint out_degree(uint v) const {
+    uint d = 0;
+    for (const uint64_t w : this->row(v)) {
+      d += std::popcount(w);
+    }
+    return d;
+  }
+
+  // Forward range of the edges out of a vertex, produced from the set
+  // bits of its row.
+  class edge_range {
+  public:
+    class iterator {
+    public:
+      using value_type = edge<uint, E>;
+      using difference_type = std::ptrdiff_t;
+      using iterator_concept = std::forward_iterator_tag;
+      using iterator_category = std::input_iterator_tag;
+
+      iterator() {}
+
+      iterator(const dense_bitset_graph *g, uint v, uint w, uint64_t bits)
+        : _g(g), _v(v), _w(w), _bits(bits) {
+        this->_skip();
+      }
+
+      value_type operator*() const {
+        const uint u = this->_w * 64 + std::countr_zero(this->_bits);
+        return {this->_v, u, this->_g->_labels[this->_g->_cell(this->_v, u)]};
+      }
+
+      iterator &operator++() {
+        this->_bits &= this->_bits - 1;
+        this->_skip();
+        return *this;
+      }
+
+      iterator operator++(int) {
+        iterator it = *this;
+        ++*this;
+        return it;
+      }
+
+      bool operator==(const iterator &other) const {
+        return this->_w == other._w && this->_bits == other._bits;
+      }
+
+    private:
+      const dense_bitset_graph *_g = nullptr;
+      uint _v = 0;
+      uint _w = 0;
+      uint64_t _bits = 0;
+
+      // Move to the next set bit (or to the end).
+      void _skip() {
+        while (!this->_bits && this->_w < this->_g->_words) {
+          if (++this->_w < this->_g->_words) {
+            this->_bits = this->_g->_rows[std::size_t{this->_v} * this->_g->_words + this->_w];
+          }
+        }
+      }
+    };
+
+    edge_range(const dense_bitset_graph *g, uint v) : _g(g), _v(v) {}
+
+    iterator begin() const {
+      return {this->_g, this->_v, 0, this->_g->row(this->_v)[0]};
+    }
+
+    iterator end() const {
+      return {this->_g, this->_v, this->_g->_words, 0};
+    }
+
+  private:
+    const dense_bitset_graph *_g;
+    uint _v;
+  };
+
+  edge_range out_edges(uint v) const {
+    this->_check(v);
+    return {this, v};
+  }
+
+  // Word-parallel traversals.
+
+  // Empty vertex set.
+  mask empty_mask() const {
+    if constexpr (fixed) {
+      return {};
+    } else {
+      return mask(this->_words, 0);
+    }
+  }
+
+  static bool test(const mask &m, uint v) {
+    return m[v / 64] & _bit(v);
+  }
+
+  static uint count(const mask &m) {
+    uint c = 0;
+    for (const uint64_t w : m) {
+      c += std::popcount(w);
+    }
+    return c;
+  }
+
+  // Set of vertices reachable from [src] (including itself).
+  mask reachable(uint src) const {
+    this->_check(src);
+    mask visited = this->empty_mask(), frontier = this->empty_mask();
+    frontier[src / 64] = _bit(src);
+    visited[src / 64] = _bit(src);
+    while (this->_expand(frontier, visited)) {}
+    return visited;
+  }
+
+  // Number of edges on a shortest path from [src] to each vertex
+  // (max uint if unreachable), one BFS level at a time.
+  table<uint> bfs(uint src) const {
+    this->_check(src);
+    table<uint> dist;
+    if constexpr (!fixed) {
+      dist.resize(this->_n);
+    }
+    std::fill(dist.begin(), dist.end(), std::numeric_limits<uint>::max());
+    mask visited = this->empty_mask(), frontier = this->empty_mask();
+    frontier[src / 64] = _bit(src);
+    visited[src / 64] = _bit(src);
+    for (uint d = 0;; d++) {
+      this->_for_each(frontier, [&dist, d](uint v) {
+        dist[v] = d;
+      });
+      if (!this->_expand(frontier, visited)) {
+        break;
+      }
+    }
+    return dist;
+  }
+
+  // Vertices reachable from [src] in depth-first preorder (visiting
+  // neighbors in increasing order).
+  std::vector<uint> dfs(uint src) const {
+    this->_check(src);
+    std::vector<uint> order = {src}, stack = {src};
+    mask visited = this->empty_mask();
+    visited[src / 64] = _bit(src);
+    while (!stack.empty()) {
+      // Lowest unvisited neighbor of the vertex on top of the stack.
+      const uint64_t *r = this->_rows.data() + std::size_t{stack.back()} * this->_words;
+      uint next = this->_n;
+      for (uint w = 0; w < this->_words; w++) {
+        if (const uint64_t bits = r[w] & ~visited[w]) {
+          next = w * 64 + std::countr_zero(bits);
+          break;
+        }
+      }
+      if (next == this->_n) {
+        stack.pop_back();
+      } else {
+        visited[next / 64] |= _bit(next);
+        order.push_back(next);
+        stack.push_back(next);
+      }
+    }
+    return order;
+  }
+
+  // Vertices in topological order, one layer of sources at a time
+  // (in increasing order within a layer). Like kahn::topsort, if the
+  // graph has a cycle the result is missing the vertices on or after
+  // it.
+  std::vector<uint> topsort() const {
+    std::vector<uint> order;
+    order.reserve(this->_n);
+    mask remaining = this->empty_mask(), targets = this->empty_mask();
+    for (uint v = 0; v < this->_n; v++) {
+      remaining[v / 64] |= _bit(v);
+    }
+    for (;;) {
+      // Sources: remaining vertices no remaining vertex points to.
+      std::fill(targets.begin(), targets.end(), 0);
+      this->_for_each(remaining, [this, &targets](uint v) {
+        this->_or_row(targets, v);
+      });
+      bool any = false;
+      for (uint w = 0; w < this->_words; w++) {
+        const uint64_t sources = remaining[w] & ~targets[w];
+        remaining[w] &= ~sources;
+        for (uint64_t bits = sources; bits; bits &= bits - 1) {
+          order.push_back(w * 64 + std::countr_zero(bits));
+          any = true;
+        }
+      }
+      if (!any) {
+        return order;
+      }
+    }
+  }
+
+  // Transitive closure: edge v -> u whenever u is reachable from v by
+  // a nonempty path (Warshall's algorithm, a row OR at a time). The
+  // labels are default values.
+  dense_bitset_graph closure() const {
+    dense_bitset_graph c = *this;
+    std::fill(c._labels.begin(), c._labels.end(), E{});
+    for (uint k = 0; k < this->_n; k++) {
+      const uint64_t *rk = c._rows.data() + std::size_t{k} * this->_words;
+      for (uint v = 0; v < this->_n; v++) {
+        if (c._word(v, k) & _bit(k)) {
+          uint64_t *rv = c._rows.data() + std::size_t{v} * this->_words;
+          for (uint w = 0; w < this->_words; w++) {
+            rv[w] |= rk[w];
+          }
+        }
+      }
+    }
+    return c;
+  }
+
+private:
+  uint _n;
+  uint _words; // Words per row.
+  storage<uint64_t, N * fixed_words> _rows{};
+  storage<E, fixed ? N * N : 0> _labels{};
+
+  // Empty graph with [n] vertices (used to delegate to the right
+  // constructor).
+  static dense_bitset_graph _make(uint n) {
+    if constexpr (fixed) {
+      if (n > N) {
+        throw std::invalid_argument("too many vertices");
+      }
+      return dense_bitset_graph();
+    } else {
+      return dense_bitset_graph(n);
+    }
+  }
+
+  static constexpr uint64_t _bit(uint v) {
+    return uint64_t{1} << (v % 64);
+  }
+
+  void _check(uint v) const {
+    if (v >= this->_n) {
+      throw std::invalid_argument("vertex not in graph");
+    }
+  }
+
+  uint64_t &_word(uint v1, uint v2) {
+    return this->_rows[std::size_t{v1} * this->_words + v2 / 64];
+  }
+
+  uint64_t _word(uint v1, uint v2) const {
+    return this->_rows[std::size_t{v1} * this->_words + v2 / 64];
+  }
+
+  // Position of the label of v1 -> v2 (widened, as n * n overflows
+  // 32 bits from n = 65536).
+  std::size_t _cell(uint v1, uint v2) const {
+    return std::size_t{v1} * this->_n + v2;
+  }
+
+  void _set(uint v1, uint v2, const E &lbl) {
+    this->_word(v1, v2) |= _bit(v2);
+    this->_labels[this->_cell(v1, v2)] = lbl;
+  }
+
+  void _or_row(mask &m, uint v) const {
+    const uint64_t *r = this->_rows.data() + std::size_t{v} * this->_words;
+    for (uint w = 0; w < this->_words; w++) {
+      m[w] |= r[w];
+    }
+  }
+
+  // Call [f] on each vertex in [m].
+  template <typename F>
+  void _for_each(const mask &m, F f) const {
+    for (uint w = 0; w < this->_words; w++) {
+      for (uint64_t bits = m[w]; bits; bits &= bits - 1) {
+        f(w * 64 + std::countr_zero(bits));
+      }
+    }
+  }
+
+  // Replace [frontier] by its unvisited out-neighbors, and add them
+  // to [visited]. Returns false if there are none.
+  bool _expand(mask &frontier, mask &visited) const {
+    mask next = this->empty_mask();
+    this->_for_each(frontier, [this, &next](uint v) {
+      this->_or_row(next, v);
+    });
+    bool any = false;
+    for (uint w = 0; w < this->_words; w++) {
+      next[w] &= ~visited[w];
+      visited[w] |= next[w];
+      any |= next[w] != 0;
+    }
+    frontier = std::move(next);
+    return any;
+  }
+};
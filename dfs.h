@@ -2,41 +2,61 @@
 
 #pragma once
 
+#include <memory_resource>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "common.h"
 #include "graph.h"
+#include "instrument.h"
 
 namespace dfs {
-  template <typename V, typename E>
-  std::vector<edge<V, E>> find_path(const graph<V, E> &g,
-                                    const V &src,
-                                    const V &dest) {
+
+  // All scratch state is allocated from memory resource [mr] (see
+  // workspace.h), and operation counts are recorded by instrumentation
+  // policy [stats] (see instrument.h).
+  template <common::Graph G,
+            instrument::Policy S = instrument::none>
+  std::vector<common::edge_t<G>> find_path(const G &g,
+                                           const common::vertex_t<G> &src,
+                                           const common::vertex_t<G> &dest,
+                                           std::pmr::memory_resource *mr =
+                                           std::pmr::get_default_resource(),
+                                           S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+
+    // Count scratch allocations (when instrumented).
+    instrument::resource<S> counted(mr, stats);
+    mr = counted.get();
+
     // Set of unvisited vertices.
-    std::vector<V> unvisited{src};
+    std::pmr::vector<V> unvisited({src}, mr);
 
     // Mapping of each vertex to its immediate predecessor on the
     // current best-known path from the source.
-    std::unordered_map<V, V> pred;
+    std::pmr::unordered_map<V, V> pred(mr);
 
     // Set of visited vertices to avoid processing the same vertex
     // more than once in case of cycles.
-    std::unordered_set<V> seen;
+    std::pmr::unordered_set<V> seen(mr);
     seen.insert(src);
 
     while (!unvisited.empty()) {
       V u = unvisited.back();
       unvisited.pop_back();
+      stats.settle();
 
       if (u == dest) {
         return common::build_path(g, pred, src, dest);
       }
 
-      for (const auto &e : g.edges(u)) {
+      for (const auto &e : g.out_edges(u)) {
+        stats.relax();
         if (!seen.contains(e.v2)) {
 	  seen.insert(e.v2);
 	  pred.emplace(e.v2, u);
 	  unvisited.push_back(e.v2);
+	  stats.heap_insert();
         }
       }
     }
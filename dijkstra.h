@@ -2,13 +2,23 @@
 
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "binary_heap.h"
 #include "common.h"
+#include "generator.h"
 #include "graph.h"
+#include "instrument.h"
+#include "path.h"
+#include "scan_heap.h"
 
 namespace dijkstra {
 
@@ -33,24 +43,37 @@ namespace dijkstra {
   // simply performing a linear scan to find the minimum element (and
   // another to remove it).
 
-  template <typename V, common::Numeric E>
-  std::vector<edge<V, E>> shortest_path(const graph<V, E> &g,
-                                        const V &src,
-                                        const V &dest) {
+  // All scratch state is allocated from memory resource [mr] (see
+  // workspace.h), and operation counts are recorded by instrumentation
+  // policy [stats] (see instrument.h). Vertices not yet in 'dist'
+  // implicitly have max distance value, so we don't pay for
+  // initializing all of them when the destination turns out to be
+  // close to the source.
+
+  template <common::WeightedGraph G,
+            instrument::Policy S = instrument::none>
+  std::vector<common::edge_t<G>> shortest_path(const G &g,
+                                               const common::vertex_t<G> &src,
+                                               const common::vertex_t<G> &dest,
+                                               std::pmr::memory_resource *mr =
+                                               std::pmr::get_default_resource(),
+                                               S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    // Count scratch allocations (when instrumented).
+    instrument::resource<S> counted(mr, stats);
+    mr = counted.get();
+
     // Mapping of each vertex to its current tentative distance value.
-    std::unordered_map<V, E> dist;
+    std::pmr::unordered_map<V, E> dist(mr);
 
     // Mapping of each vertex to its immediate predecessor on the
     // current best-known path from the source.
-    std::unordered_map<V, V> pred;
+    std::pmr::unordered_map<V, V> pred(mr);
 
     // Set of unvisited vertices.
-    std::vector<V> unvisited{src};
-
-    // Initialize all vertices with max distance value.
-    for (const auto &v : g.vertices()) {
-      dist[v] = std::numeric_limits<E>::max();
-    }
+    std::pmr::vector<V> unvisited({src}, mr);
 
     // Initialize source vertex distance to 0.
     dist[src] = static_cast<E>(0);
@@ -59,12 +82,14 @@ namespace dijkstra {
     while (!unvisited.empty()) {
       // Remove the vertex with the smallest tentative distance value
       // from the 'unvisited' set.
-      std::function<E(const V&)> f = [&dist = std::as_const(dist)](const V &v) {
+      auto f = [&dist = std::as_const(dist)](const V &v) {
         return dist.at(v);
       };
       uint min_i = common::min_index(unvisited, f);
       V u = unvisited[min_i];
       unvisited.erase(unvisited.begin() + min_i);
+      stats.extract();
+      stats.settle();
 
       // If 'u' is the destination, then we're done. We know we've
       // found the shortest path to it because the algorithm always
@@ -81,13 +106,18 @@ namespace dijkstra {
 
       // For each neighbor of 'u', update their tentative distance
       // values if it becomes shorter through 'u'.
-      for (const auto &e : g.edges(u)) {
-        const E d = dist[u] + e.label;
-        if (d < dist[e.v2]) {
+      const E du = dist.at(u);
+      for (const auto &e : g.out_edges(u)) {
+        stats.relax();
+        const E d = du + e.label;
+        if (auto it = dist.find(e.v2); it == dist.end() || d < it->second) {
           dist[e.v2] = d;
           pred[e.v2] = u;
           if (!common::contains(unvisited, e.v2)) {
             unvisited.push_back(e.v2);
+            stats.heap_insert();
+          } else {
+            stats.decrease_key();
           }
         }
       }
@@ -98,31 +128,25 @@ namespace dijkstra {
     throw std::invalid_argument("destination doesn't exist");
   }
 
-  // Alternate version that uses a binary min-heap for the 'unvisited'
-  // set. Appears to perform a bit better on the PE#83 example.
-  template <typename V, common::Numeric E>
-  std::vector<edge<V, E>> shortest_path2(const graph<V, E> &g,
-                                         const V &src,
-                                         const V &dest) {
-    // Mapping of each vertex to its current tentative distance value.
-    std::unordered_map<V, E> dist;
-
-    // Mapping of each vertex to its immediate predecessor on the
-    // current best-known path from the source.
-    std::unordered_map<V, V> pred;
+  // Search of 'shortest_path2', filling in [dist] and [pred] until
+  // [dest] is settled. Returns whether it was reached.
+  template <common::WeightedGraph G, typename Dist, typename Pred,
+            instrument::Policy S>
+  bool _search2(const G &g,
+                const common::vertex_t<G> &src,
+                const common::vertex_t<G> &dest,
+                Dist &dist,
+                Pred &pred,
+                std::pmr::memory_resource *mr,
+                S &stats) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
 
     // Initialize source vertex distance to 0.
     dist[src] = static_cast<E>(0);
 
-    // Initialize all other vertices with max distance value.
-    for (const auto &v : g.vertices()) {
-      if (v != src) {
-        dist[v] = std::numeric_limits<E>::max();
-      }
-    }
-
     // Set of unvisited vertices.
-    binary_heap<V, E> unvisited;
+    binary_heap<V, E> unvisited(mr);
     unvisited.insert(src, dist[src]);
 
     // Main loop.
@@ -130,6 +154,8 @@ namespace dijkstra {
       // Remove the vertex with the smallest tentative distance value
       // from the 'unvisited' set.
       V u = unvisited.extract().first;
+      stats.extract();
+      stats.settle();
 
       // If 'u' is the destination, then we're done. We know we've
       // found the shortest path to it because the algorithm always
@@ -140,21 +166,155 @@ namespace dijkstra {
       // never happens because it never visits the same node twice
       // because it doesn't have to, for exactly the reason we just
       // described).
+      if (u == dest) {
+        return true;
+      }
+
+      // For each neighbor of 'u', update their tentative distance
+      // values if it becomes shorter through 'u'.
+      const E du = dist.at(u);
+      for (const auto &e : g.out_edges(u)) {
+        stats.relax();
+        const E d = du + e.label;
+        if (auto it = dist.find(e.v2); it == dist.end() || d < it->second) {
+          dist[e.v2] = d;
+          pred[e.v2] = u;
+          if (!unvisited.contains(e.v2)) {
+            unvisited.insert(e.v2, d);
+            stats.heap_insert();
+          } else {
+            unvisited.decrease_key(e.v2, d);
+            stats.decrease_key();
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  // Alternate version that uses a binary min-heap for the 'unvisited'
+  // set. Appears to perform a bit better on the PE#83 example.
+  template <common::WeightedGraph G,
+            instrument::Policy S = instrument::none>
+  std::vector<common::edge_t<G>> shortest_path2(const G &g,
+                                                const common::vertex_t<G> &src,
+                                                const common::vertex_t<G> &dest,
+                                                std::pmr::memory_resource *mr =
+                                                std::pmr::get_default_resource(),
+                                                S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    // Count scratch allocations (when instrumented).
+    instrument::resource<S> counted(mr, stats);
+    mr = counted.get();
+
+    // Mapping of each vertex to its current tentative distance value.
+    std::pmr::unordered_map<V, E> dist(mr);
+
+    // Mapping of each vertex to its immediate predecessor on the
+    // current best-known path from the source.
+    std::pmr::unordered_map<V, V> pred(mr);
+
+    if (_search2(g, src, dest, dist, pred, mr, stats)) {
+      return common::build_path(g, pred, src, dest);
+    }
+
+    // If we've processed all vertices and never encountered the
+    // destination, then it must not have existed in the graph.
+    throw std::invalid_argument("destination doesn't exist");
+  }
+
+  // Same search as 'shortest_path2', returning the path as a
+  // 'path_result' (see path.h): its distance and its vertices in
+  // order, with the edge labels only looked up if asked for.
+  template <common::WeightedGraph G,
+            instrument::Policy S = instrument::none>
+  path_result<common::vertex_t<G>, common::label_t<G>>
+  shortest_path_result(const G &g,
+                       const common::vertex_t<G> &src,
+                       const common::vertex_t<G> &dest,
+                       std::pmr::memory_resource *mr =
+                       std::pmr::get_default_resource(),
+                       S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    // Count scratch allocations (when instrumented).
+    instrument::resource<S> counted(mr, stats);
+    mr = counted.get();
+
+    std::pmr::unordered_map<V, E> dist(mr);
+    std::pmr::unordered_map<V, V> pred(mr);
+    if (_search2(g, src, dest, dist, pred, mr, stats)) {
+      return paths::build(pred, dist, src, dest);
+    }
+    throw std::invalid_argument("destination doesn't exist");
+  }
+
+  // Alternate version of 'shortest_path' that keeps the tentative
+  // distances of the unvisited vertices in a contiguous array (see
+  // scan_heap.h) instead of looking them up in 'dist' during the
+  // linear scan, so the minimum is found with a vectorized argmin
+  // (see simd.h). Beats 'shortest_path2' while the 'unvisited' set
+  // stays small, i.e., up to a few thousand vertices.
+  template <common::WeightedGraph G,
+            instrument::Policy S = instrument::none>
+  std::vector<common::edge_t<G>> shortest_path3(const G &g,
+                                                const common::vertex_t<G> &src,
+                                                const common::vertex_t<G> &dest,
+                                                std::pmr::memory_resource *mr =
+                                                std::pmr::get_default_resource(),
+                                                S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    // Count scratch allocations (when instrumented).
+    instrument::resource<S> counted(mr, stats);
+    mr = counted.get();
+
+    // Mapping of each vertex to its current tentative distance value.
+    std::pmr::unordered_map<V, E> dist(mr);
+
+    // Mapping of each vertex to its immediate predecessor on the
+    // current best-known path from the source.
+    std::pmr::unordered_map<V, V> pred(mr);
+
+    // Initialize source vertex distance to 0.
+    dist[src] = static_cast<E>(0);
+
+    // Set of unvisited vertices.
+    scan_heap<V, E> unvisited(mr);
+    unvisited.insert(src, dist[src]);
+
+    // Main loop.
+    while (unvisited.size()) {
+      // Remove the vertex with the smallest tentative distance value
+      // from the 'unvisited' set.
+      V u = unvisited.extract().first;
+      stats.extract();
+      stats.settle();
+
+      // If 'u' is the destination, then we're done (see above).
       if (u == dest) {
         return common::build_path(g, pred, src, dest);
       }
 
       // For each neighbor of 'u', update their tentative distance
       // values if it becomes shorter through 'u'.
-      for (const auto &e : g.edges(u)) {
-        const E d = dist[u] + e.label;
-        if (d < dist[e.v2]) {
+      const E du = dist.at(u);
+      for (const auto &e : g.out_edges(u)) {
+        stats.relax();
+        const E d = du + e.label;
+        if (auto it = dist.find(e.v2); it == dist.end() || d < it->second) {
           dist[e.v2] = d;
           pred[e.v2] = u;
           if (!unvisited.contains(e.v2)) {
             unvisited.insert(e.v2, d);
+            stats.heap_insert();
           } else {
             unvisited.decrease_key(e.v2, d);
+            stats.decrease_key();
           }
         }
       }
@@ -164,4 +324,308 @@ namespace dijkstra {
     // destination, then it must not have existed in the graph.
     throw std::invalid_argument("destination doesn't exist");
   }
+
+  // Distances from a source to every vertex reachable from it, and
+  // the predecessor of each on a shortest path (a shortest path tree).
+  template <typename V, typename E>
+  struct shortest_path_tree {
+    std::unordered_map<V, E> dist;
+    std::unordered_map<V, V> pred;
+  };
+
+  // Build the shortest path tree of [g] from [src]. Ties between
+  // equally short paths are broken toward the smallest predecessor,
+  // so with positive weights the tree is unique (pred[v] is the
+  // smallest u with dist[u] + w(u, v) = dist[v]) -- dynamic_sssp.h
+  // maintains exactly this tree under edge updates.
+  template <common::WeightedGraph G,
+            instrument::Policy S = instrument::none>
+  requires std::totally_ordered<common::vertex_t<G>>
+  shortest_path_tree<common::vertex_t<G>, common::label_t<G>> tree(const G &g,
+                                                                   const common::vertex_t<G> &src,
+                                                                   std::pmr::memory_resource *mr =
+                                                                   std::pmr::get_default_resource(),
+                                                                   S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    // Count scratch allocations (when instrumented).
+    instrument::resource<S> counted(mr, stats);
+    mr = counted.get();
+
+    shortest_path_tree<V, E> t;
+    t.dist[src] = static_cast<E>(0);
+
+    binary_heap<V, E> unvisited(mr);
+    unvisited.insert(src, t.dist[src]);
+
+    while (unvisited.size()) {
+      V u = unvisited.extract().first;
+      stats.extract();
+      stats.settle();
+
+      const E du = t.dist.at(u);
+      for (const auto &e : g.out_edges(u)) {
+        stats.relax();
+        const E d = du + e.label;
+        if (auto it = t.dist.find(e.v2); it == t.dist.end() || d < it->second) {
+          t.dist[e.v2] = d;
+          t.pred[e.v2] = u;
+          if (!unvisited.contains(e.v2)) {
+            unvisited.insert(e.v2, d);
+            stats.heap_insert();
+          } else {
+            unvisited.decrease_key(e.v2, d);
+            stats.decrease_key();
+          }
+        } else if (d == it->second && unvisited.contains(e.v2) &&
+                   u < t.pred.at(e.v2)) {
+          t.pred[e.v2] = u;
+        }
+      }
+    }
+
+    return t;
+  }
+
+  // Variant of 'shortest_path2' that searches [g] as if the vertices
+  // for which [skip_vertex] returns true (other than [src]) and the
+  // edges for which [skip_edge] returns true weren't there, so that
+  // callers can run many searches on slightly different graphs
+  // without copying [g] (see ksp.h). Vertices are prioritized by
+  // their distance plus [potential] (zero by default), which must be
+  // a consistent lower bound on the remaining distance to [dest] (as
+  // in A*). Returns the path with its edges labeled by their weights,
+  // or nothing if [dest] is unreachable.
+  template <common::WeightedGraph G,
+            std::predicate<const common::vertex_t<G>&> VP,
+            std::predicate<const common::edge_t<G>&> EP,
+            std::invocable<const common::vertex_t<G>&> H,
+            instrument::Policy S = instrument::none>
+  std::optional<std::vector<common::edge_t<G>>>
+  shortest_path_masked(const G &g,
+                       const common::vertex_t<G> &src,
+                       const common::vertex_t<G> &dest,
+                       VP &&skip_vertex,
+                       EP &&skip_edge,
+                       H &&potential,
+                       std::pmr::memory_resource *mr =
+                       std::pmr::get_default_resource(),
+                       S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    // Count scratch allocations (when instrumented).
+    instrument::resource<S> counted(mr, stats);
+    mr = counted.get();
+
+    // Mapping of each vertex to its current tentative distance value.
+    std::pmr::unordered_map<V, E> dist(mr);
+
+    // Mapping of each vertex to the last edge on the current
+    // best-known path to it from the source.
+    std::pmr::unordered_map<V, edge<V, E>> pred(mr);
+
+    dist[src] = static_cast<E>(0);
+    binary_heap<V, E> unvisited(mr);
+    unvisited.insert(src, potential(src));
+
+    while (unvisited.size()) {
+      V u = unvisited.extract().first;
+      stats.extract();
+      stats.settle();
+
+      if (u == dest) {
+        std::vector<edge<V, E>> path;
+        for (V cur = dest; cur != src;) {
+          const edge<V, E> &e = pred.at(cur);
+          path.push_back(e);
+          cur = e.v1;
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+      }
+
+      const E du = dist.at(u);
+      for (const auto &e : g.out_edges(u)) {
+        stats.relax();
+        if (skip_edge(e) || (e.v2 != src && skip_vertex(e.v2))) {
+          continue;
+        }
+        const E d = du + e.label;
+        if (auto it = dist.find(e.v2); it == dist.end() || d < it->second) {
+          dist[e.v2] = d;
+          pred.insert_or_assign(e.v2, e);
+          if (!unvisited.contains(e.v2)) {
+            unvisited.insert(e.v2, d + potential(e.v2));
+            stats.heap_insert();
+          } else {
+            unvisited.decrease_key(e.v2, d + potential(e.v2));
+            stats.decrease_key();
+          }
+        }
+      }
+    }
+
+    return {};
+  }
+
+  // Same without a potential (plain Dijkstra).
+  template <common::WeightedGraph G,
+            std::predicate<const common::vertex_t<G>&> VP,
+            std::predicate<const common::edge_t<G>&> EP,
+            instrument::Policy S = instrument::none>
+  std::optional<std::vector<common::edge_t<G>>>
+  shortest_path_masked(const G &g,
+                       const common::vertex_t<G> &src,
+                       const common::vertex_t<G> &dest,
+                       VP &&skip_vertex,
+                       EP &&skip_edge,
+                       std::pmr::memory_resource *mr =
+                       std::pmr::get_default_resource(),
+                       S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    return shortest_path_masked(g, src, dest, skip_vertex, skip_edge,
+                                [](const V&) { return static_cast<E>(0); },
+                                mr, stats);
+  }
+
+  // Resumable one-to-all search from a source, settling vertices only
+  // as the caller asks for them: 'settle' yields (vertex, distance)
+  // pairs in the order Dijkstra's algorithm settles them, so callers
+  // can stop after the k nearest targets, past a distance bound, or
+  // once a set of targets is reached, without paying for the rest of
+  // the graph. The search state (distances, predecessor edges and the
+  // open set) stays in the object, so a later 'settle' carries on
+  // where the last one stopped, and 'path' rebuilds the path to any
+  // settled vertex from the predecessors on demand.
+  //
+  // The object refers to [g], and generators from 'settle' refer to
+  // the object, so both must outlive them.
+  template <common::WeightedGraph G>
+  class lazy_search {
+  public:
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    lazy_search(const G &g, const V &src,
+                std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+      : _g(&g), _src(src), _dist(mr), _pred(mr), _open(mr) {
+      if (!g.contains(src)) {
+        throw std::invalid_argument("source doesn't exist");
+      }
+      this->_dist[src] = static_cast<E>(0);
+      this->_open.insert(src, static_cast<E>(0));
+    }
+
+    // Settle the remaining vertices one at a time, in increasing
+    // distance order. Each is fully processed (its edges relaxed)
+    // before it's yielded, so stopping at any point leaves the search
+    // consistent.
+    generator<std::pair<V, E>> settle() {
+      while (this->_open.size()) {
+        const auto [u, du] = this->_open.extract();
+        for (const auto &e : this->_g->out_edges(u)) {
+          const E d = du + e.label;
+          if (auto it = this->_dist.find(e.v2); it == this->_dist.end()) {
+            this->_dist.emplace(e.v2, d);
+            this->_pred.insert_or_assign(e.v2, e);
+            this->_open.insert(e.v2, d);
+          } else if (d < it->second) {
+            it->second = d;
+            this->_pred.insert_or_assign(e.v2, e);
+            this->_open.decrease_key(e.v2, d);
+          }
+        }
+        co_yield std::pair<V, E>(u, du);
+      }
+    }
+
+    // Whether every vertex reachable from the source has been settled.
+    bool done() const {
+      return this->_open.size() == 0;
+    }
+
+    bool settled(const V &v) const {
+      return this->_dist.contains(v) && !this->_open.contains(v);
+    }
+
+    // Distance to settled vertex [v] (nothing if it isn't settled).
+    std::optional<E> distance(const V &v) const {
+      if (!this->settled(v)) {
+        return {};
+      }
+      return this->_dist.at(v);
+    }
+
+    // Shortest path to settled vertex [v], with its edges labeled by
+    // their weights (throws if [v] isn't settled).
+    std::vector<edge<V, E>> path(const V &v) const {
+      if (!this->settled(v)) {
+        throw std::invalid_argument("vertex not settled");
+      }
+      std::vector<edge<V, E>> path;
+      for (V cur = v; cur != this->_src;) {
+        const edge<V, E> &e = this->_pred.at(cur);
+        path.push_back(e);
+        cur = e.v1;
+      }
+      std::reverse(path.begin(), path.end());
+      return path;
+    }
+
+  private:
+    const G *_g;
+    V _src;
+    std::pmr::unordered_map<V, E> _dist;
+    std::pmr::unordered_map<V, edge<V, E>> _pred;
+    binary_heap<V, E> _open;
+  };
+
+  // The (up to) [k] vertices of [targets] nearest to [src] in [g],
+  // nearest first, with their distances. Stops searching as soon as
+  // they're found.
+  template <common::WeightedGraph G>
+  std::vector<std::pair<common::vertex_t<G>, common::label_t<G>>>
+  nearest(const G &g,
+          const common::vertex_t<G> &src,
+          const std::unordered_set<common::vertex_t<G>> &targets,
+          uint k,
+          std::pmr::memory_resource *mr = std::pmr::get_default_resource()) {
+    std::vector<std::pair<common::vertex_t<G>, common::label_t<G>>> found;
+    if (k == 0) {
+      return found;
+    }
+    lazy_search<G> search(g, src, mr);
+    for (const auto &[v, d] : search.settle()) {
+      if (targets.contains(v)) {
+        found.push_back({v, d});
+        if (found.size() == k) {
+          break;
+        }
+      }
+    }
+    return found;
+  }
+
+  // The vertices within distance [bound] of [src] in [g], nearest
+  // first, with their distances.
+  template <common::WeightedGraph G>
+  std::vector<std::pair<common::vertex_t<G>, common::label_t<G>>>
+  within(const G &g,
+         const common::vertex_t<G> &src,
+         const common::label_t<G> &bound,
+         std::pmr::memory_resource *mr = std::pmr::get_default_resource()) {
+    std::vector<std::pair<common::vertex_t<G>, common::label_t<G>>> found;
+    lazy_search<G> search(g, src, mr);
+    for (const auto &[v, d] : search.settle()) {
+      if (d > bound) {
+        break;
+      }
+      found.push_back({v, d});
+    }
+    return found;
+  }
 }
@@ -0,0 +1,288 @@
+// Dynamic minimum spanning forest under edge insertions and weight
+// decreases, backed by a link-cut tree. Every vertex and every forest
+// edge is a node of the link-cut tree (edge u-v is linked between u
+// and v), and each node knows the heaviest edge in its splay subtree.
+// Inserting edge u-v with weight w then takes O(log n) amortized:
+//
+// - if u and v aren't connected, link them with the new edge;
+// - otherwise, find the heaviest edge on the forest path from u to v,
+//   and if it's heavier than w, cut it and link the new edge instead
+//   (otherwise the new edge isn't part of the forest).
+//
+// Decreasing the weight of an edge is the same as inserting it again
+// with the new weight (the heavier copy gets swapped out if it was in
+// the forest).
+
+#pragma once
+
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+#include "graph.h"
+
+template <typename V, common::Numeric E>
+class dynamic_msf {
+public:
+  dynamic_msf() {
+    this->_nodes.push_back({}); // Node 0 is the null node.
+  }
+
+  // Start with the minimum spanning forest of (undirected) graph [g].
+  explicit dynamic_msf(const graph<V, E> &g) : dynamic_msf() {
+    for (const auto &v : g.vertex_view()) {
+      this->add_vertex(v);
+    }
+    for (const auto &v : g.vertex_view()) {
+      for (const auto &e : g.out_edges(v)) {
+        this->insert_edge(e.v1, e.v2, e.label);
+      }
+    }
+  }
+
+  // Add isolated vertex [v] (does nothing if it already exists).
+  void add_vertex(const V &v) {
+    if (!this->_ixs.contains(v)) {
+      this->_ixs[v] = this->_new_node(v, v, {}, false);
+    }
+  }
+
+  // Insert undirected edge [v1]-[v2] with weight [w] (missing
+  // vertices are added). Returns true if the forest changed.
+  bool insert_edge(const V &v1, const V &v2, const E &w) {
+    this->add_vertex(v1);
+    this->add_vertex(v2);
+    if (v1 == v2) {
+      return false;
+    }
+    const uint x = this->_ixs.at(v1);
+    const uint y = this->_ixs.at(v2);
+
+    if (this->_find_root(x) == this->_find_root(y)) {
+      // Heaviest edge on the path, which the new edge replaces if
+      // it's lighter.
+      this->_make_root(x);
+      this->_access(y);
+      this->_splay(y);
+      const uint max = this->_nodes[y].max;
+      if (!(w < this->_nodes[max].w)) {
+        return false;
+      }
+      this->_cut_edge(max);
+    }
+
+    const uint e = this->_new_node(v1, v2, w, true);
+    this->_link(x, e);
+    this->_link(e, y);
+    this->_total += w;
+    this->_num_edges++;
+    return true;
+  }
+
+  // Decrease the weight of edge [v1]-[v2] to [w]. Returns true if the
+  // forest changed.
+  bool decrease_weight(const V &v1, const V &v2, const E &w) {
+    return this->insert_edge(v1, v2, w);
+  }
+
+  bool connected(const V &v1, const V &v2) {
+    auto x = this->_ixs.find(v1);
+    auto y = this->_ixs.find(v2);
+    if (x == this->_ixs.end() || y == this->_ixs.end()) {
+      throw std::invalid_argument("vertex doesn't exist");
+    }
+    return this->_find_root(x->second) == this->_find_root(y->second);
+  }
+
+  // Total weight of the forest.
+  constexpr E total_weight() const {
+    return this->_total;
+  }
+
+  constexpr uint num_edges() const {
+    return this->_num_edges;
+  }
+
+  constexpr uint num_vertices() const {
+    return this->_ixs.size();
+  }
+
+  // Edges of the forest (in no particular order).
+  std::vector<edge<V, E>> edges() const {
+    std::vector<edge<V, E>> es;
+    es.reserve(this->_num_edges);
+    for (const auto &n : this->_nodes) {
+      if (n.is_edge) {
+        es.push_back({n.v1, n.v2, n.w});
+      }
+    }
+    return es;
+  }
+
+private:
+  struct node {
+    uint ch[2] = {0, 0};
+    uint p = 0;
+    bool rev = false;
+    bool is_edge = false; // False for vertices and free nodes.
+    E w{};
+    uint max = 0; // Heaviest edge node in splay subtree (0 if none).
+    V v1{}, v2{};
+  };
+
+  std::vector<node> _nodes;
+  std::vector<uint> _free;
+  std::unordered_map<V, uint> _ixs;
+  E _total{};
+  uint _num_edges = 0;
+
+  uint _new_node(const V &v1, const V &v2, const E &w, bool is_edge) {
+    uint x;
+    if (is_edge && !this->_free.empty()) {
+      x = this->_free.back();
+      this->_free.pop_back();
+    } else {
+      x = this->_nodes.size();
+      this->_nodes.push_back({});
+    }
+    node &n = this->_nodes[x];
+    n = {};
+    n.is_edge = is_edge;
+    n.w = w;
+    n.max = is_edge ? x : 0;
+    n.v1 = v1;
+    n.v2 = v2;
+    return x;
+  }
+
+  // Cut forest edge node [e] out of the tree and free it.
+  void _cut_edge(uint e) {
+    const uint x = this->_ixs.at(this->_nodes[e].v1);
+    const uint y = this->_ixs.at(this->_nodes[e].v2);
+    this->_cut(x, e);
+    this->_cut(e, y);
+    this->_total -= this->_nodes[e].w;
+    this->_num_edges--;
+    this->_nodes[e] = {};
+    this->_free.push_back(e);
+  }
+
+  // Link-cut tree operations.
+
+  bool _is_root(uint x) const {
+    const uint p = this->_nodes[x].p;
+    return !p || (this->_nodes[p].ch[0] != x && this->_nodes[p].ch[1] != x);
+  }
+
+  void _push(uint x) {
+    node &n = this->_nodes[x];
+    if (n.rev) {
+      std::swap(n.ch[0], n.ch[1]);
+      for (uint c : n.ch) {
+        if (c) {
+          this->_nodes[c].rev = !this->_nodes[c].rev;
+        }
+      }
+      n.rev = false;
+    }
+  }
+
+  void _pull(uint x) {
+    node &n = this->_nodes[x];
+    n.max = n.is_edge ? x : 0;
+    for (uint c : n.ch) {
+      const uint m = this->_nodes[c].max;
+      if (c && m && (!n.max || this->_nodes[n.max].w < this->_nodes[m].w)) {
+        n.max = m;
+      }
+    }
+  }
+
+  void _rotate(uint x) {
+    const uint p = this->_nodes[x].p;
+    const uint g = this->_nodes[p].p;
+    const uint d = this->_nodes[p].ch[1] == x;
+    const uint b = this->_nodes[x].ch[!d];
+    if (!this->_is_root(p)) {
+      this->_nodes[g].ch[this->_nodes[g].ch[1] == p] = x;
+    }
+    this->_nodes[x].p = g;
+    this->_nodes[x].ch[!d] = p;
+    this->_nodes[p].p = x;
+    this->_nodes[p].ch[d] = b;
+    if (b) {
+      this->_nodes[b].p = p;
+    }
+    this->_pull(p);
+    this->_pull(x);
+  }
+
+  void _splay(uint x) {
+    // Push reversal flags down from the root of x's splay tree.
+    std::vector<uint> &path = this->_path;
+    path.clear();
+    for (uint y = x;; y = this->_nodes[y].p) {
+      path.push_back(y);
+      if (this->_is_root(y)) {
+        break;
+      }
+    }
+    for (auto it = path.rbegin(); it != path.rend(); it++) {
+      this->_push(*it);
+    }
+
+    while (!this->_is_root(x)) {
+      const uint p = this->_nodes[x].p;
+      if (!this->_is_root(p)) {
+        const uint g = this->_nodes[p].p;
+        const bool zigzig = (this->_nodes[g].ch[1] == p) == (this->_nodes[p].ch[1] == x);
+        this->_rotate(zigzig ? p : x);
+      }
+      this->_rotate(x);
+    }
+  }
+
+  // Make the path from the root to [x] preferred.
+  void _access(uint x) {
+    for (uint last = 0, y = x; y; last = y, y = this->_nodes[y].p) {
+      this->_splay(y);
+      this->_nodes[y].ch[1] = last;
+      this->_pull(y);
+    }
+    this->_splay(x);
+  }
+
+  void _make_root(uint x) {
+    this->_access(x);
+    this->_nodes[x].rev = !this->_nodes[x].rev;
+  }
+
+  uint _find_root(uint x) {
+    this->_access(x);
+    for (this->_push(x); this->_nodes[x].ch[0]; this->_push(x)) {
+      x = this->_nodes[x].ch[0];
+    }
+    this->_splay(x);
+    return x;
+  }
+
+  void _link(uint x, uint y) {
+    this->_make_root(x);
+    this->_nodes[x].p = y;
+  }
+
+  void _cut(uint x, uint y) {
+    this->_make_root(x);
+    this->_access(y);
+    // Now x is y's left child (they're adjacent).
+    this->_nodes[y].ch[0] = 0;
+    this->_nodes[x].p = 0;
+    this->_pull(y);
+  }
+
+  // Scratch space for '_splay'.
+  std::vector<uint> _path;
+};
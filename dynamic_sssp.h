@@ -0,0 +1,311 @@
+// Dynamic single-source shortest paths (Ramalingam and Reps). Owns a
+// directed graph and its shortest path tree from a fixed source, and
+// repairs the tree after each edge insertion, deletion or weight
+// change instead of recomputing it. The work done is proportional to
+// the number of vertices whose distance (or predecessor) actually
+// changes, plus their edges.
+//
+// Edge weights must be positive. The tree is always exactly the one
+// 'dijkstra::tree' would build from scratch: the same distances, and
+// the same predecessors (the smallest vertex through which a
+// shortest path arrives).
+
+#pragma once
+
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "binary_heap.h"
+#include "common.h"
+#include "dijkstra.h"
+#include "graph.h"
+
+template <typename V, common::Numeric E>
+requires std::totally_ordered<V>
+class dynamic_sssp {
+public:
+  // Take a copy of [g] and build its shortest path tree from [src].
+  dynamic_sssp(const graph<V, E> &g, const V &src)
+    : _g(g), _src(src) {
+    if (!this->_g.contains(src)) {
+      throw std::invalid_argument("source doesn't exist");
+    }
+    for (const auto &v : this->_g.vertex_view()) {
+      this->_rev.add_vertex(v);
+    }
+    std::vector<edge<V, E>> reversed;
+    for (const auto &v : this->_g.vertex_view()) {
+      for (const auto &e : this->_g.out_edges(v)) {
+        _check_weight(e.label);
+        reversed.push_back({e.v2, e.v1, e.label});
+      }
+    }
+    this->_rev.add_edges(reversed, true);
+    auto t = dijkstra::tree(this->_g, src);
+    this->_dist = std::move(t.dist);
+    this->_pred = std::move(t.pred);
+  }
+
+  const graph<V, E> &get_graph() const {
+    return this->_g;
+  }
+
+  constexpr const V &source() const {
+    return this->_src;
+  }
+
+  bool reachable(const V &v) const {
+    return this->_dist.contains(v);
+  }
+
+  // Distance from the source to [v] (throws if unreachable).
+  E distance(const V &v) const {
+    if (auto it = this->_dist.find(v); it != this->_dist.end()) {
+      return it->second;
+    }
+    throw std::invalid_argument("vertex unreachable");
+  }
+
+  // Distances and predecessors of all reachable vertices.
+  const std::unordered_map<V, E> &distances() const {
+    return this->_dist;
+  }
+
+  const std::unordered_map<V, V> &predecessors() const {
+    return this->_pred;
+  }
+
+  // Shortest path from the source to [dest] (empty if [dest] is the
+  // source or unreachable).
+  std::vector<edge<V, E>> path(const V &dest) const {
+    return common::build_path(this->_g, this->_pred, this->_src, dest);
+  }
+
+  // Add edge [v1] -> [v2] with weight [w], or change its weight if it
+  // already exists (missing vertices are added). Returns the number
+  // of vertices whose distance or predecessor was recomputed.
+  uint set_edge(const V &v1, const V &v2, const E &w) {
+    _check_weight(w);
+    for (const auto &v : {v1, v2}) {
+      if (!this->_g.contains(v)) {
+        this->_g.add_vertex(v);
+        this->_rev.add_vertex(v);
+      }
+    }
+    std::optional<E> old;
+    for (const auto &e : this->_g.out_edges(v1)) {
+      if (e.v2 == v2) {
+        old = e.label;
+      }
+    }
+    this->_g.add_edge(v1, v2, w, true);
+    this->_rev.add_edge(v2, v1, w, true);
+    if (!old.has_value() || w < old.value()) {
+      return this->_decrease(v1, v2, w);
+    } else if (old.value() < w) {
+      return this->_increase(v1, v2);
+    }
+    return 0;
+  }
+
+  // Remove edge [v1] -> [v2] (if it exists). Returns the number of
+  // vertices whose distance or predecessor was recomputed.
+  uint remove_edge(const V &v1, const V &v2) {
+    if (!this->_g.contains(v1) || !this->_g.contains(v2)) {
+      return 0;
+    }
+    for (const auto &e : this->_g.out_edges(v1)) {
+      if (e.v2 == v2) {
+        const E w = e.label;
+        this->_g.remove_edge({v1, v2, w}, true);
+        this->_rev.remove_edge({v2, v1, w}, true);
+        return this->_increase(v1, v2);
+      }
+    }
+    return 0;
+  }
+
+private:
+  graph<V, E> _g;
+  graph<V, E> _rev; // '_g' with the edges reversed.
+  V _src;
+  std::unordered_map<V, E> _dist;
+  std::unordered_map<V, V> _pred;
+
+  static void _check_weight(const E &w) {
+    if (!(static_cast<E>(0) < w)) {
+      throw std::invalid_argument("edge weights must be positive");
+    }
+  }
+
+  // Recompute the predecessor of reachable vertex [v] (the smallest
+  // vertex with a tight edge into it).
+  void _repred(const V &v) {
+    if (v == this->_src) {
+      return;
+    }
+    const E dv = this->_dist.at(v);
+    std::optional<V> best;
+    for (const auto &e : this->_rev.out_edges(v)) {
+      if (auto it = this->_dist.find(e.v2);
+          it != this->_dist.end() && it->second + e.label == dv &&
+          (!best.has_value() || e.v2 < best.value())) {
+        best = e.v2;
+      }
+    }
+    this->_pred[v] = best.value();
+  }
+
+  // Edge [u] -> [v] was added or got cheaper (now [w]). Distances can
+  // only decrease, so propagate the improvement Dijkstra-style from
+  // [v].
+  uint _decrease(const V &u, const V &v, const E &w) {
+    auto du = this->_dist.find(u);
+    if (du == this->_dist.end()) {
+      return 0;
+    }
+    const E d = du->second + w;
+    if (auto dv = this->_dist.find(v); dv != this->_dist.end() && d >= dv->second) {
+      // At best a new tie.
+      if (d == dv->second && v != this->_src && u < this->_pred.at(v)) {
+        this->_pred[v] = u;
+        return 1;
+      }
+      return 0;
+    }
+
+    // Vertices whose distance improved, and whose predecessor may
+    // have changed because of a new tie.
+    std::vector<V> improved;
+    std::unordered_set<V> tied;
+
+    binary_heap<V, E> q;
+    this->_dist[v] = d;
+    q.insert(v, d);
+    while (q.size()) {
+      const auto [x, dx] = q.extract();
+      improved.push_back(x);
+      for (const auto &e : this->_g.out_edges(x)) {
+        const E dy = dx + e.label;
+        if (auto it = this->_dist.find(e.v2); it == this->_dist.end() || dy < it->second) {
+          this->_dist[e.v2] = dy;
+          if (q.contains(e.v2)) {
+            q.decrease_key(e.v2, dy);
+          } else {
+            q.insert(e.v2, dy);
+          }
+        } else if (dy == it->second) {
+          tied.insert(e.v2);
+        }
+      }
+    }
+
+    for (const auto &x : improved) {
+      this->_repred(x);
+      tied.erase(x);
+    }
+    for (const auto &x : tied) {
+      this->_repred(x);
+    }
+    return improved.size() + tied.size();
+  }
+
+  // Edge [u] -> [v] was removed or got more expensive. Distances can
+  // only increase, and only for vertices in the subtree of [v] that
+  // are left without any tight incoming edge from outside it.
+  uint _increase(const V &u, const V &v) {
+    if (auto p = this->_pred.find(v); p == this->_pred.end() || p->second != u) {
+      // Not a tree edge. Since the predecessor is the smallest tight
+      // one, it stays tight and nothing changes.
+      return 0;
+    }
+
+    // Phase 1: find the affected vertices, visiting candidates (tree
+    // children of affected vertices) in order of their old distance.
+    // A candidate with a tight edge from an unaffected vertex (which
+    // must be closer to the source, so has already been classified)
+    // keeps its distance and just needs a new predecessor.
+    std::unordered_set<V> affected;
+    std::vector<V> repred;
+    binary_heap<V, E> candidates;
+    candidates.insert(v, this->_dist.at(v));
+    while (candidates.size()) {
+      const auto [x, dx] = candidates.extract();
+      bool supported = false;
+      for (const auto &e : this->_rev.out_edges(x)) {
+        if (auto it = this->_dist.find(e.v2);
+            it != this->_dist.end() && !affected.contains(e.v2) &&
+            it->second + e.label == dx) {
+          supported = true;
+          break;
+        }
+      }
+      if (supported) {
+        repred.push_back(x);
+        continue;
+      }
+      affected.insert(x);
+      for (const auto &e : this->_g.out_edges(x)) {
+        if (auto p = this->_pred.find(e.v2);
+            p != this->_pred.end() && p->second == x && !candidates.contains(e.v2)) {
+          candidates.insert(e.v2, this->_dist.at(e.v2));
+        }
+      }
+    }
+
+    // Phase 2: forget the affected distances, seed each affected
+    // vertex with its best edge from an unaffected one, and run
+    // Dijkstra over the affected vertices only.
+    for (const auto &x : affected) {
+      this->_dist.erase(x);
+      this->_pred.erase(x);
+    }
+    binary_heap<V, E> q;
+    std::unordered_map<V, E> tentative;
+    for (const auto &x : affected) {
+      std::optional<E> best;
+      for (const auto &e : this->_rev.out_edges(x)) {
+        if (auto it = this->_dist.find(e.v2); it != this->_dist.end()) {
+          const E d = it->second + e.label;
+          if (!best.has_value() || d < best.value()) {
+            best = d;
+          }
+        }
+      }
+      if (best.has_value()) {
+        q.insert(x, best.value());
+        tentative[x] = best.value();
+      }
+    }
+    std::vector<V> settled;
+    while (q.size()) {
+      const auto [x, dx] = q.extract();
+      this->_dist[x] = dx;
+      settled.push_back(x);
+      for (const auto &e : this->_g.out_edges(x)) {
+        if (!affected.contains(e.v2) || this->_dist.contains(e.v2)) {
+          continue;
+        }
+        const E d = dx + e.label;
+        if (auto it = tentative.find(e.v2); it == tentative.end()) {
+          tentative[e.v2] = d;
+          q.insert(e.v2, d);
+        } else if (d < it->second) {
+          it->second = d;
+          q.decrease_key(e.v2, d);
+        }
+      }
+    }
+
+    for (const auto &x : settled) {
+      this->_repred(x);
+    }
+    for (const auto &x : repred) {
+      this->_repred(x);
+    }
+    return affected.size() + repred.size();
+  }
+};
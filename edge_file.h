@@ -0,0 +1,126 @@
+// Binary edge list files, for streaming large graphs to disk (e.g.,
+// from the generators in generators.h) and reading them back in
+// bounded-size blocks without ever building a graph. A file is a
+// header followed by the raw 'edge' structs, so files are only
+// portable between builds with the same vertex and label types.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+
+struct edge_file_header {
+  char magic[8];
+  uint32_t vertex_size;  // sizeof(V)
+  uint32_t label_size;   // sizeof(E)
+  uint64_t num_vertices; // Vertices are assumed to be numbered 0 to n-1.
+  uint64_t num_edges;
+};
+
+constexpr char edge_file_magic[8] = {'C', 'G', 'E', 'D', 'G', 'E', 'S', '1'};
+
+// Appends edges to a new file. Callable with a span of edges so it can
+// be used directly as a generator sink.
+template <typename V, typename E>
+class edge_file_writer {
+public:
+  edge_file_writer(const std::string &path, uint64_t num_vertices)
+    : _out(path, std::ios::binary | std::ios::trunc) {
+    if (!this->_out) {
+      throw std::runtime_error("can't open " + path);
+    }
+    std::memcpy(this->_header.magic, edge_file_magic, sizeof(edge_file_magic));
+    this->_header.vertex_size = sizeof(V);
+    this->_header.label_size = sizeof(E);
+    this->_header.num_vertices = num_vertices;
+    this->_header.num_edges = 0;
+    this->_write_header();
+  }
+
+  ~edge_file_writer() {
+    if (this->_out.is_open()) {
+      this->_out.seekp(0);
+      this->_write_header();
+    }
+  }
+
+  void operator()(std::span<const edge<V, E>> es) {
+    this->_out.write(reinterpret_cast<const char*>(es.data()), es.size_bytes());
+    if (!this->_out) {
+      throw std::runtime_error("write failed");
+    }
+    this->_header.num_edges += es.size();
+  }
+
+  // Finish the file (recording the final edge count in the header).
+  void close() {
+    this->_out.seekp(0);
+    this->_write_header();
+    this->_out.close();
+    if (!this->_out) {
+      throw std::runtime_error("write failed");
+    }
+  }
+
+private:
+  std::ofstream _out;
+  edge_file_header _header;
+
+  void _write_header() {
+    this->_out.write(reinterpret_cast<const char*>(&this->_header), sizeof(this->_header));
+    this->_out.seekp(0, std::ios::end);
+  }
+};
+
+// Reads the edges of a file in blocks.
+template <typename V, typename E>
+class edge_file_reader {
+public:
+  explicit edge_file_reader(const std::string &path)
+    : _in(path, std::ios::binary) {
+    if (!this->_in) {
+      throw std::runtime_error("can't open " + path);
+    }
+    this->_in.read(reinterpret_cast<char*>(&this->_header), sizeof(this->_header));
+    if (!this->_in ||
+        std::memcmp(this->_header.magic, edge_file_magic, sizeof(edge_file_magic))) {
+      throw std::runtime_error(path + " is not an edge file");
+    }
+    if (this->_header.vertex_size != sizeof(V) || this->_header.label_size != sizeof(E)) {
+      throw std::runtime_error(path + " has different vertex or label types");
+    }
+  }
+
+  constexpr uint64_t num_vertices() const {
+    return this->_header.num_vertices;
+  }
+
+  constexpr uint64_t num_edges() const {
+    return this->_header.num_edges;
+  }
+
+  // Read up to [max] of the next edges into [out] (replacing its
+  // contents). Returns false when there are no edges left.
+  bool read(std::vector<edge<V, E>> &out, std::size_t max) {
+    const uint64_t n = std::min<uint64_t>(max, this->num_edges() - this->_read);
+    out.resize(n);
+    this->_in.read(reinterpret_cast<char*>(out.data()), n * sizeof(edge<V, E>));
+    if (!this->_in) {
+      throw std::runtime_error("read failed");
+    }
+    this->_read += n;
+    return n > 0;
+  }
+
+private:
+  std::ifstream _in;
+  edge_file_header _header;
+  uint64_t _read = 0;
+};
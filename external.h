@@ -0,0 +1,564 @@
+// Semi-external graph algorithms, for graphs whose edges don't fit in
+// memory. The graph lives on disk as a CSR file (offsets, then
+// targets, then weights), which 'csr_file' maps into memory read-only,
+// so the OS pages the edges in and out as needed. Only per-vertex state
+// (distances, union-find parents, the best edge of each component) is
+// kept in RAM: O(n) words where 'graph' needs O(n + m) plus hash map
+// overhead.
+//
+// The algorithms read the edges in increasing vertex order, so access
+// is sequential. Most passes are full scans ('csr_file::scan'), which
+// ask the OS to read ahead the next block while the current one is
+// processed and drop the blocks already done. Sparse BFS levels read
+// only the frontier's edges (in vertex order, prefetching ahead).
+//
+// - 'bfs': hop distances from a source. Levels with many edges scan
+//   the whole file.
+// - 'components': connected components (weakly connected, if the file
+//   is directed) with array union-find, in a single scan.
+// - 'mst': minimum spanning forest by Boruvka rounds. Each round is one
+//   scan that finds the lightest edge leaving each component, and the
+//   components are merged through union-find, as in Kruskal. There are
+//   at most log2(n) rounds.
+//
+// CSR files are written from an in-memory graph ('write') or converted
+// from an edge file (see edge_file.h) without loading it ('convert').
+// Vertices are numbered 0 to n-1. Like edge files, CSR files are only
+// portable between builds with the same vertex and label types.
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "common.h"
+#include "edge_file.h"
+#include "graph.h"
+
+struct csr_file_header {
+  char magic[8];
+  uint32_t vertex_size;  // sizeof(V)
+  uint32_t label_size;   // sizeof(E)
+  uint64_t num_vertices;
+  uint64_t num_edges;
+};
+
+constexpr char csr_file_magic[8] = {'C', 'G', 'C', 'S', 'R', '0', '0', '1'};
+
+// Byte offsets of the sections of a CSR file with [n] vertices and [m]
+// edges: n + 1 64-bit edge offsets, m targets and m weights, each
+// section 8-byte aligned.
+template <typename V, typename E>
+struct csr_file_layout {
+  uint64_t offsets, targets, weights, size;
+
+  csr_file_layout(uint64_t n, uint64_t m) {
+    auto align = [](uint64_t x) {
+      return (x + 7) & ~uint64_t{7};
+    };
+    this->offsets = sizeof(csr_file_header);
+    this->targets = this->offsets + 8 * (n + 1);
+    this->weights = align(this->targets + m * sizeof(V));
+    this->size = this->weights + m * sizeof(E);
+  }
+};
+
+// Read-only memory mapping of a CSR file.
+template <std::integral V, typename E>
+class csr_file {
+public:
+  // Bytes of edges per block read ahead by 'scan'.
+  static constexpr uint64_t default_block = 64 << 20;
+
+  explicit csr_file(const std::string &path) {
+    this->_fd = ::open(path.c_str(), O_RDONLY);
+    if (this->_fd < 0) {
+      throw std::runtime_error("can't open " + path);
+    }
+    struct stat st;
+    if (::fstat(this->_fd, &st) < 0 ||
+        static_cast<uint64_t>(st.st_size) < sizeof(csr_file_header)) {
+      this->_close();
+      throw std::runtime_error(path + " is not a CSR file");
+    }
+    this->_size = st.st_size;
+    void *p = ::mmap(nullptr, this->_size, PROT_READ, MAP_SHARED, this->_fd, 0);
+    if (p == MAP_FAILED) {
+      this->_close();
+      throw std::runtime_error("can't map " + path);
+    }
+    this->_base = static_cast<const char*>(p);
+
+    std::memcpy(&this->_header, this->_base, sizeof(this->_header));
+    if (std::memcmp(this->_header.magic, csr_file_magic, sizeof(csr_file_magic))) {
+      this->_close();
+      throw std::runtime_error(path + " is not a CSR file");
+    }
+    if (this->_header.vertex_size != sizeof(V) || this->_header.label_size != sizeof(E)) {
+      this->_close();
+      throw std::runtime_error(path + " has different vertex or label types");
+    }
+    const csr_file_layout<V, E> layout(this->num_vertices(), this->num_edges());
+    if (layout.size != this->_size) {
+      this->_close();
+      throw std::runtime_error(path + " is truncated");
+    }
+    this->_offsets = reinterpret_cast<const uint64_t*>(this->_base + layout.offsets);
+    this->_targets = reinterpret_cast<const V*>(this->_base + layout.targets);
+    this->_weights = reinterpret_cast<const E*>(this->_base + layout.weights);
+  }
+
+  csr_file(const csr_file&) = delete;
+  csr_file &operator=(const csr_file&) = delete;
+
+  ~csr_file() {
+    this->_close();
+  }
+
+  constexpr uint64_t num_vertices() const {
+    return this->_header.num_vertices;
+  }
+
+  constexpr uint64_t num_edges() const {
+    return this->_header.num_edges;
+  }
+
+  constexpr bool contains(const V &v) const {
+    return v >= 0 && static_cast<uint64_t>(v) < this->num_vertices();
+  }
+
+  uint64_t degree(const V &v) const {
+    return this->_offsets[v + 1] - this->_offsets[v];
+  }
+
+  // Targets and weights of the out-edges of [v] (pointing into the
+  // mapping, so reading them may page them in).
+  std::span<const V> targets(const V &v) const {
+    return {this->_targets + this->_offsets[v], this->degree(v)};
+  }
+
+  std::span<const E> weights(const V &v) const {
+    return {this->_weights + this->_offsets[v], this->degree(v)};
+  }
+
+  // Ask the OS to start reading the edges of vertices [first, last)
+  // in the background.
+  void prefetch(const V &first, const V &last) const {
+    this->_advise_edges(first, last, MADV_WILLNEED);
+  }
+
+  // Tell the OS we're done with the edges of vertices [first, last)
+  // for now (so they're the first pages it evicts).
+  void release(const V &first, const V &last) const {
+    this->_advise_edges(first, last, MADV_DONTNEED);
+  }
+
+  // Call [f](v, targets, weights) on each vertex in increasing order,
+  // reading ahead [block] bytes of edges at a time.
+  template <typename F>
+  void scan(F f, uint64_t block = default_block) const {
+    const uint64_t n = this->num_vertices();
+    const uint64_t block_edges = std::max<uint64_t>(1, block / (sizeof(V) + sizeof(E)));
+    // End of the block starting at vertex [first] (at least one vertex).
+    auto block_end = [&](uint64_t first) {
+      const uint64_t *end = std::upper_bound(this->_offsets + first + 1, this->_offsets + n + 1,
+                                             this->_offsets[first] + block_edges);
+      return std::max<uint64_t>(first + 1, end - this->_offsets - 1);
+    };
+
+    this->_advise(this->_base, this->_size, MADV_SEQUENTIAL);
+    uint64_t first = 0;
+    uint64_t last = n ? block_end(0) : 0;
+    this->prefetch(first, last);
+    while (first < n) {
+      const uint64_t next = last < n ? block_end(last) : n;
+      this->prefetch(last, next);
+      for (uint64_t v = first; v < last; v++) {
+        f(static_cast<V>(v), this->targets(v), this->weights(v));
+      }
+      this->release(first, last);
+      first = last;
+      last = next;
+    }
+    this->_advise(this->_base, this->_size, MADV_NORMAL);
+  }
+
+private:
+  int _fd = -1;
+  const char *_base = nullptr;
+  uint64_t _size = 0;
+  csr_file_header _header;
+  const uint64_t *_offsets = nullptr;
+  const V *_targets = nullptr;
+  const E *_weights = nullptr;
+
+  void _close() {
+    if (this->_base) {
+      ::munmap(const_cast<char*>(this->_base), this->_size);
+      this->_base = nullptr;
+    }
+    if (this->_fd >= 0) {
+      ::close(this->_fd);
+      this->_fd = -1;
+    }
+  }
+
+  // madvise the pages overlapping [p, p + len).
+  void _advise(const void *p, uint64_t len, int advice) const {
+    static const uint64_t page = ::sysconf(_SC_PAGESIZE);
+    if (len == 0) {
+      return;
+    }
+    const uint64_t begin = reinterpret_cast<uintptr_t>(p) & ~(page - 1);
+    const uint64_t end = reinterpret_cast<uintptr_t>(p) + len;
+    ::madvise(reinterpret_cast<void*>(begin), end - begin, advice);
+  }
+
+  void _advise_edges(uint64_t first, uint64_t last, int advice) const {
+    if (first >= last) {
+      return;
+    }
+    const uint64_t begin = this->_offsets[first];
+    const uint64_t end = this->_offsets[last];
+    this->_advise(this->_targets + begin, (end - begin) * sizeof(V), advice);
+    this->_advise(this->_weights + begin, (end - begin) * sizeof(E), advice);
+  }
+};
+
+namespace external {
+
+  // Distance of vertices not reachable from the source.
+  constexpr uint unreachable = std::numeric_limits<uint>::max();
+
+  // Default memory budget of 'convert' for the edges being placed.
+  constexpr uint64_t default_memory = uint64_t{1} << 30;
+
+  // Write the CSR file of [g] (whose vertices must be 0 to n-1) to
+  // [path], with the out-edges of each vertex in the order 'out_edges'
+  // gives them.
+  template <common::Graph G>
+  requires std::integral<common::vertex_t<G>>
+  void write(const G &g, const std::string &path) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+    const uint64_t n = g.num_vertices();
+    std::vector<uint64_t> offsets(n + 1, 0);
+    for (uint64_t v = 0; v < n; v++) {
+      if (!g.contains(static_cast<V>(v))) {
+        throw std::invalid_argument("vertices must be 0 to n-1");
+      }
+      offsets[v + 1] = offsets[v] + std::ranges::distance(g.out_edges(static_cast<V>(v)));
+    }
+
+    csr_file_header header;
+    std::memcpy(header.magic, csr_file_magic, sizeof(csr_file_magic));
+    header.vertex_size = sizeof(V);
+    header.label_size = sizeof(E);
+    header.num_vertices = n;
+    header.num_edges = offsets[n];
+    const csr_file_layout<V, E> layout(n, offsets[n]);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      throw std::runtime_error("can't open " + path);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    std::vector<V> targets;
+    for (uint64_t v = 0; v < n; v++) {
+      targets.clear();
+      for (const auto &e : g.out_edges(static_cast<V>(v))) {
+        targets.push_back(e.v2);
+      }
+      out.write(reinterpret_cast<const char*>(targets.data()), targets.size() * sizeof(V));
+    }
+    out.seekp(layout.weights);
+    std::vector<E> weights;
+    for (uint64_t v = 0; v < n; v++) {
+      weights.clear();
+      for (const auto &e : g.out_edges(static_cast<V>(v))) {
+        weights.push_back(e.label);
+      }
+      out.write(reinterpret_cast<const char*>(weights.data()), weights.size() * sizeof(E));
+    }
+    out.close();
+    if (!out) {
+      throw std::runtime_error("write failed");
+    }
+  }
+
+  // Convert the edge file at [edge_path] to a CSR file at [csr_path]
+  // without loading the graph: one pass over the edges counts the
+  // degrees, then each further pass places the edges of as many
+  // vertices as fit in [memory] bytes and writes them out
+  // sequentially. Unless [directed], each edge is stored in both
+  // directions.
+  template <std::integral V, typename E>
+  void convert(const std::string &edge_path, const std::string &csr_path,
+               bool directed = false, uint64_t memory = default_memory) {
+    constexpr std::size_t batch = 1 << 20;
+    std::vector<edge<V, E>> es;
+
+    // Degrees, then offsets.
+    std::vector<uint64_t> offsets;
+    {
+      edge_file_reader<V, E> in(edge_path);
+      const uint64_t n = in.num_vertices();
+      offsets.assign(n + 1, 0);
+      while (in.read(es, batch)) {
+        for (const auto &e : es) {
+          if (e.v1 < 0 || static_cast<uint64_t>(e.v1) >= n ||
+              e.v2 < 0 || static_cast<uint64_t>(e.v2) >= n) {
+            throw std::runtime_error(edge_path + " has a vertex out of range");
+          }
+          offsets[e.v1 + 1]++;
+          if (!directed) {
+            offsets[e.v2 + 1]++;
+          }
+        }
+      }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    const uint64_t n = offsets.size() - 1;
+    const uint64_t m = offsets[n];
+
+    csr_file_header header;
+    std::memcpy(header.magic, csr_file_magic, sizeof(csr_file_magic));
+    header.vertex_size = sizeof(V);
+    header.label_size = sizeof(E);
+    header.num_vertices = n;
+    header.num_edges = m;
+    const csr_file_layout<V, E> layout(n, m);
+
+    std::ofstream out(csr_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      throw std::runtime_error("can't open " + csr_path);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+
+    // Place the edges of vertices [first, last) per pass.
+    const uint64_t window = std::max<uint64_t>(1, memory / (sizeof(V) + sizeof(E)));
+    std::vector<V> targets;
+    std::vector<E> weights;
+    std::vector<uint64_t> pos;
+    for (uint64_t first = 0; first < n; ) {
+      const uint64_t *end = std::upper_bound(offsets.data() + first + 1, offsets.data() + n + 1,
+                                             offsets[first] + window);
+      const uint64_t last = std::max<uint64_t>(first + 1, end - offsets.data() - 1);
+      const uint64_t base = offsets[first];
+      targets.resize(offsets[last] - base);
+      weights.resize(offsets[last] - base);
+      pos.assign(offsets.begin() + first, offsets.begin() + last);
+
+      auto place = [&](V v1, V v2, const E &label) {
+        if (static_cast<uint64_t>(v1) >= first && static_cast<uint64_t>(v1) < last) {
+          const uint64_t i = pos[v1 - first]++ - base;
+          targets[i] = v2;
+          weights[i] = label;
+        }
+      };
+      edge_file_reader<V, E> in(edge_path);
+      while (in.read(es, batch)) {
+        for (const auto &e : es) {
+          place(e.v1, e.v2, e.label);
+          if (!directed) {
+            place(e.v2, e.v1, e.label);
+          }
+        }
+      }
+
+      out.seekp(layout.targets + base * sizeof(V));
+      out.write(reinterpret_cast<const char*>(targets.data()), targets.size() * sizeof(V));
+      out.seekp(layout.weights + base * sizeof(E));
+      out.write(reinterpret_cast<const char*>(weights.data()), weights.size() * sizeof(E));
+      first = last;
+    }
+    // Make sure the file has its full size even if the last section
+    // is empty.
+    out.seekp(0, std::ios::end);
+    if (static_cast<uint64_t>(out.tellp()) < layout.size) {
+      out.seekp(layout.size - 1);
+      out.put(0);
+    }
+    out.close();
+    if (!out) {
+      throw std::runtime_error("write failed");
+    }
+  }
+
+  // Union-find over vertices 0 to n-1 in a flat array. Linking the
+  // larger root under the smaller keeps each root the smallest vertex
+  // of its set; path halving keeps the trees shallow.
+  template <std::integral V>
+  class _forest {
+  public:
+    explicit _forest(uint64_t n) : _parent(n) {
+      std::iota(this->_parent.begin(), this->_parent.end(), V{0});
+    }
+
+    V find(V x) {
+      while (this->_parent[x] != x) {
+        this->_parent[x] = this->_parent[this->_parent[x]];
+        x = this->_parent[x];
+      }
+      return x;
+    }
+
+    // Merge the sets of [x] and [y] (false if already the same).
+    bool unite(V x, V y) {
+      x = this->find(x);
+      y = this->find(y);
+      if (x == y) {
+        return false;
+      }
+      if (y < x) {
+        std::swap(x, y);
+      }
+      this->_parent[y] = x;
+      return true;
+    }
+
+  private:
+    std::vector<V> _parent;
+  };
+
+  // Hop distances in [g] from [src] (or 'unreachable'), indexed by
+  // vertex. Levels whose frontier has more than 1/[dense] of the edges
+  // are done by a full scan; the others visit the frontier in vertex
+  // order, prefetching the edges of the next [lookahead] vertices.
+  template <std::integral V, typename E>
+  std::vector<uint> bfs(const csr_file<V, E> &g, const V &src,
+                        uint dense = 16, uint lookahead = 1024) {
+    if (!g.contains(src)) {
+      throw std::invalid_argument("source doesn't exist");
+    }
+    std::vector<uint> dist(g.num_vertices(), unreachable);
+    std::vector<V> frontier{src}, next;
+    dist[src] = 0;
+    for (uint d = 1; !frontier.empty(); d++) {
+      next.clear();
+      auto visit = [&](std::span<const V> targets) {
+        for (const V w : targets) {
+          if (dist[w] == unreachable) {
+            dist[w] = d;
+            next.push_back(w);
+          }
+        }
+      };
+
+      uint64_t edges = 0;
+      for (const V v : frontier) {
+        edges += g.degree(v);
+      }
+      if (edges > g.num_edges() / dense) {
+        g.scan([&](V v, std::span<const V> targets, std::span<const E>) {
+          if (dist[v] == d - 1) {
+            visit(targets);
+          }
+        });
+      } else {
+        // The first block up front, then each block one block ahead.
+        for (std::size_t j = 0; j < std::min<std::size_t>(frontier.size(), lookahead); j++) {
+          g.prefetch(frontier[j], frontier[j] + 1);
+        }
+        for (std::size_t i = 0; i < frontier.size(); i++) {
+          if (i % lookahead == 0) {
+            const std::size_t end = std::min(frontier.size(), i + 2 * lookahead);
+            for (std::size_t j = i + lookahead; j < end; j++) {
+              g.prefetch(frontier[j], frontier[j] + 1);
+            }
+          }
+          visit(g.targets(frontier[i]));
+        }
+      }
+
+      std::sort(next.begin(), next.end());
+      std::swap(frontier, next);
+    }
+    return dist;
+  }
+
+  // Connected component of each vertex of [g], identified by its
+  // smallest vertex (edge directions are ignored).
+  template <std::integral V, typename E>
+  std::vector<V> components(const csr_file<V, E> &g) {
+    _forest<V> f(g.num_vertices());
+    g.scan([&f](V v, std::span<const V> targets, std::span<const E>) {
+      for (const V w : targets) {
+        f.unite(v, w);
+      }
+    });
+    std::vector<V> comp(g.num_vertices());
+    for (uint64_t v = 0; v < comp.size(); v++) {
+      comp[v] = f.find(v);
+    }
+    return comp;
+  }
+
+  // Minimum spanning forest of [g] (edge directions are ignored). Ties
+  // between equal weights are broken by the endpoints, so the forest
+  // is unique.
+  template <std::integral V, typename E>
+  requires common::Numeric<E>
+  std::vector<edge<V, E>> mst(const csr_file<V, E> &g) {
+    const uint64_t n = g.num_vertices();
+    _forest<V> f(n);
+    std::vector<edge<V, E>> forest;
+
+    // Lightest edge leaving each component (indexed by root).
+    struct candidate {
+      bool found = false;
+      E w;
+      V lo, hi;
+    };
+    std::vector<candidate> best(n);
+    auto offer = [&best](V c, const E &w, V lo, V hi) {
+      candidate &b = best[c];
+      if (!b.found || std::tie(w, lo, hi) < std::tie(b.w, b.lo, b.hi)) {
+        b = {true, w, lo, hi};
+      }
+    };
+
+    for (bool merged = true; merged; ) {
+      std::fill(best.begin(), best.end(), candidate{});
+      g.scan([&](V v, std::span<const V> targets, std::span<const E> weights) {
+        const V cv = f.find(v);
+        for (std::size_t i = 0; i < targets.size(); i++) {
+          const V cw = f.find(targets[i]);
+          if (cv != cw) {
+            const V lo = std::min(v, targets[i]);
+            const V hi = std::max(v, targets[i]);
+            offer(cv, weights[i], lo, hi);
+            offer(cw, weights[i], lo, hi);
+          }
+        }
+      });
+
+      merged = false;
+      for (uint64_t c = 0; c < n; c++) {
+        if (best[c].found && f.unite(best[c].lo, best[c].hi)) {
+          forest.push_back({best[c].lo, best[c].hi, best[c].w});
+          merged = true;
+        }
+      }
+    }
+    return forest;
+  }
+}
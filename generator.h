@@ -0,0 +1,139 @@
+// Coroutine generator: a lazily computed input range whose elements are
+// produced by 'co_yield'. This is std::generator (C++23) where the
+// standard library has it, and otherwise a minimal stand-in with the
+// same usage for our purposes (iterate it once with range-for or the
+// range algorithms; elements are yielded by value).
+
+#pragma once
+
+#include <version>
+
+#ifdef __cpp_lib_generator
+
+#include <generator>
+
+template <typename T>
+using generator = std::generator<T>;
+
+#else
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+template <typename T>
+class generator {
+public:
+  struct promise_type {
+    std::optional<T> value;
+    std::exception_ptr error;
+
+    generator get_return_object() {
+      return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() noexcept {
+      return {};
+    }
+
+    std::suspend_always final_suspend() noexcept {
+      return {};
+    }
+
+    std::suspend_always yield_value(T x) {
+      this->value = std::move(x);
+      return {};
+    }
+
+    void return_void() {}
+
+    void unhandled_exception() {
+      this->error = std::current_exception();
+    }
+  };
+
+  class iterator {
+  public:
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() {}
+
+    explicit iterator(std::coroutine_handle<promise_type> h) : _h(h) {}
+
+    T &operator*() const {
+      return *this->_h.promise().value;
+    }
+
+    iterator &operator++() {
+      this->_h.resume();
+      this->_check();
+      return *this;
+    }
+
+    void operator++(int) {
+      ++*this;
+    }
+
+    bool operator==(std::default_sentinel_t) const {
+      return !this->_h || this->_h.done();
+    }
+
+  private:
+    std::coroutine_handle<promise_type> _h;
+
+    friend class generator;
+
+    // Rethrow what the coroutine threw, if anything.
+    void _check() {
+      if (this->_h.done() && this->_h.promise().error) {
+        std::rethrow_exception(std::exchange(this->_h.promise().error, nullptr));
+      }
+    }
+  };
+
+  generator(const generator&) = delete;
+  generator &operator=(const generator&) = delete;
+
+  generator(generator &&other) noexcept : _h(std::exchange(other._h, nullptr)) {}
+
+  generator &operator=(generator &&other) noexcept {
+    if (this != &other) {
+      if (this->_h) {
+        this->_h.destroy();
+      }
+      this->_h = std::exchange(other._h, nullptr);
+    }
+    return *this;
+  }
+
+  ~generator() {
+    if (this->_h) {
+      this->_h.destroy();
+    }
+  }
+
+  // Runs the coroutine up to its first element (so call once).
+  iterator begin() {
+    iterator it(this->_h);
+    if (this->_h) {
+      this->_h.resume();
+      it._check();
+    }
+    return it;
+  }
+
+  std::default_sentinel_t end() const {
+    return {};
+  }
+
+private:
+  std::coroutine_handle<promise_type> _h;
+
+  explicit generator(std::coroutine_handle<promise_type> h) : _h(h) {}
+};
+
+#endif
@@ -0,0 +1,439 @@
+// Deterministic synthetic graph generators. Every random choice is a
+// pure function of the seed and a counter (the index of the edge or
+// vertex being generated) rather than of the state of a sequential
+// RNG, so generation can be split among any number of threads and
+// the output is identical no matter how many are used.
+//
+// A generator describes a graph as a sequence of "items" (edges or
+// vertices depending on the model), each of which emits zero or more
+// edges. 'gen::generate' runs a generator in parallel in fixed-size
+// chunks of items and passes the edges of each chunk, in order, to a
+// sink: any callable taking a std::span of edges, such as a lambda
+// calling graph::add_edges or an edge_file_writer (see
+// edge_file.h). 'gen::build' and 'gen::write' do exactly that.
+//
+// Vertices are numbered 0 to n-1. Models whose 'directed' member is
+// false emit each undirected edge once.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+#include "edge_file.h"
+#include "graph.h"
+
+namespace gen {
+
+  // SplitMix64 finalizer (a bijection on 64-bit integers with good
+  // avalanche behavior).
+  constexpr uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+  }
+
+  // Random 64 bits for counter [i] of stream [stream] under [seed].
+  // Different streams are used for independent choices about the same
+  // item (e.g., the source and destination of an edge).
+  constexpr uint64_t random(uint64_t seed, uint64_t stream, uint64_t i) {
+    return mix(i + mix(seed + mix(stream)));
+  }
+
+  // Uniform integer in [0, n) from random bits [r].
+  constexpr uint64_t below(uint64_t r, uint64_t n) {
+    return (static_cast<unsigned __int128>(r) * n) >> 64;
+  }
+
+  // Uniform double in [0, 1) from random bits [r].
+  constexpr double unit(uint64_t r) {
+    return (r >> 11) * 0x1.0p-53;
+  }
+
+  // Random edge weight in [1, max_weight] (integral) or (0,
+  // max_weight] (floating point) from random bits [r].
+  template <common::Numeric E>
+  constexpr E weight(uint64_t r, E max_weight) {
+    if constexpr (std::integral<E>) {
+      return static_cast<E>(1 + below(r, max_weight));
+    } else {
+      return static_cast<E>((1.0 - unit(r)) * max_weight);
+    }
+  }
+
+  // Stream used for edge weights.
+  constexpr uint64_t weight_stream = ~0ull;
+
+  // Erdős–Rényi G(n, m): [m] directed edges between uniformly random
+  // distinct endpoints. Edges are sampled independently, so there may
+  // be a few duplicates unless m is much smaller than n².
+  template <std::integral V, common::Numeric E>
+  class erdos_renyi {
+  public:
+    using vertex_type = V;
+    using label_type = E;
+    using edge_type = edge<V, E>;
+    static constexpr bool directed = true;
+
+    erdos_renyi(uint64_t n, uint64_t m, uint64_t seed, E max_weight = 100)
+      : _n(n), _m(m), _seed(seed), _max_weight(max_weight) {
+      if (n < 2) {
+        throw std::invalid_argument("need at least two vertices");
+      }
+    }
+
+    constexpr uint64_t num_vertices() const { return this->_n; }
+    constexpr uint64_t num_items() const { return this->_m; }
+
+    // Item [i] is the i-th edge.
+    void emit(uint64_t i, std::vector<edge_type> &out) const {
+      const uint64_t u = below(random(this->_seed, 0, i), this->_n);
+      uint64_t v = u;
+      for (uint64_t stream = 1; v == u; stream++) {
+        v = below(random(this->_seed, stream, i), this->_n);
+      }
+      out.push_back({static_cast<V>(u), static_cast<V>(v),
+                     weight(random(this->_seed, weight_stream, i), this->_max_weight)});
+    }
+
+  private:
+    uint64_t _n;
+    uint64_t _m;
+    uint64_t _seed;
+    E _max_weight;
+  };
+
+  // R-MAT (recursive matrix, a.k.a. stochastic Kronecker) graph with
+  // 2^[scale] vertices and [m] directed edges. Each edge descends
+  // [scale] levels of the adjacency matrix, choosing a quadrant with
+  // probabilities [a], [b], [c] and 1-a-b-c at every level. Vertex
+  // ids are then scrambled by a bijection so that the high-degree
+  // vertices aren't all clustered at small ids. The defaults are the
+  // Graph500 parameters. Self loops are kept.
+  template <std::integral V, common::Numeric E>
+  class rmat {
+  public:
+    using vertex_type = V;
+    using label_type = E;
+    using edge_type = edge<V, E>;
+    static constexpr bool directed = true;
+
+    rmat(uint scale, uint64_t m, uint64_t seed, E max_weight = 100,
+         double a = 0.57, double b = 0.19, double c = 0.19)
+      : _scale(scale), _m(m), _seed(seed), _max_weight(max_weight),
+        _a(a), _ab(a + b), _abc(a + b + c) {
+      if (scale < 1 || scale > 62) {
+        throw std::invalid_argument("scale out of range");
+      }
+    }
+
+    constexpr uint64_t num_vertices() const { return 1ull << this->_scale; }
+    constexpr uint64_t num_items() const { return this->_m; }
+
+    // Item [i] is the i-th edge.
+    void emit(uint64_t i, std::vector<edge_type> &out) const {
+      uint64_t u = 0, v = 0;
+      for (uint level = 0; level < this->_scale; level++) {
+        const double r = unit(random(this->_seed, level, i));
+        u <<= 1;
+        v <<= 1;
+        if (r >= this->_abc) {
+          u |= 1;
+          v |= 1;
+        } else if (r >= this->_ab) {
+          u |= 1;
+        } else if (r >= this->_a) {
+          v |= 1;
+        }
+      }
+      out.push_back({static_cast<V>(this->_scramble(u)),
+                     static_cast<V>(this->_scramble(v)),
+                     weight(random(this->_seed, weight_stream, i), this->_max_weight)});
+    }
+
+  private:
+    uint _scale;
+    uint64_t _m;
+    uint64_t _seed;
+    E _max_weight;
+    double _a, _ab, _abc;
+
+    // Bijection on [0, 2^scale): odd multiplications, additions and
+    // xor-shifts are all invertible modulo a power of two.
+    constexpr uint64_t _scramble(uint64_t x) const {
+      const uint64_t mask = this->num_vertices() - 1;
+      x = (x * 0x9e3779b97f4a7c15 + mix(this->_seed)) & mask;
+      x ^= x >> (this->_scale / 2 + 1);
+      return (x * 0xbf58476d1ce4e5b9) & mask;
+    }
+  };
+
+  // Random geometric graph: [n] points uniformly distributed in the
+  // unit square, with an undirected edge between every two points
+  // closer than [radius]. Weights are proportional to distance (a
+  // distance of [radius] has weight [max_weight]). Items are vertices,
+  // each emitting its edges to higher numbered vertices. Points are
+  // bucketed into a grid of cells at least [radius] wide on
+  // construction (O(n) time and space).
+  template <std::integral V, common::Numeric E>
+  class geometric {
+  public:
+    using vertex_type = V;
+    using label_type = E;
+    using edge_type = edge<V, E>;
+    static constexpr bool directed = false;
+
+    geometric(uint64_t n, double radius, uint64_t seed, E max_weight = 100)
+      : _n(n), _radius(radius), _seed(seed), _max_weight(max_weight) {
+      if (radius <= 0) {
+        throw std::invalid_argument("radius must be positive");
+      }
+      // Cells no narrower than the radius (so all neighbors of a
+      // point are in adjacent cells), and not many more cells than
+      // points.
+      this->_cells = std::clamp<uint64_t>(std::floor(1 / radius), 1,
+                                          std::ceil(std::sqrt(n)) + 1);
+
+      // Counting sort of the vertices by cell.
+      this->_cell_start.assign(this->_cells * this->_cells + 1, 0);
+      for (uint64_t v = 0; v < n; v++) {
+        this->_cell_start[this->_cell(v) + 1]++;
+      }
+      std::partial_sum(this->_cell_start.begin(), this->_cell_start.end(),
+                       this->_cell_start.begin());
+      this->_cell_vertices.resize(n);
+      std::vector<uint64_t> next(this->_cell_start.begin(), this->_cell_start.end() - 1);
+      for (uint64_t v = 0; v < n; v++) {
+        this->_cell_vertices[next[this->_cell(v)]++] = static_cast<V>(v);
+      }
+    }
+
+    constexpr uint64_t num_vertices() const { return this->_n; }
+    constexpr uint64_t num_items() const { return this->_n; }
+
+    // Item [v] is vertex v (edges to higher numbered neighbors).
+    void emit(uint64_t v, std::vector<edge_type> &out) const {
+      const auto [x, y] = this->_position(v);
+      const int64_t cx = this->_coord(x), cy = this->_coord(y);
+      for (int64_t i = std::max<int64_t>(cx - 1, 0);
+           i <= std::min<int64_t>(cx + 1, this->_cells - 1); i++) {
+        for (int64_t j = std::max<int64_t>(cy - 1, 0);
+             j <= std::min<int64_t>(cy + 1, this->_cells - 1); j++) {
+          const uint64_t c = i * this->_cells + j;
+          for (uint64_t k = this->_cell_start[c]; k < this->_cell_start[c+1]; k++) {
+            const uint64_t w = this->_cell_vertices[k];
+            if (w <= v) {
+              continue;
+            }
+            const auto [wx, wy] = this->_position(w);
+            const double d = std::hypot(wx - x, wy - y);
+            if (d < this->_radius) {
+              out.push_back({static_cast<V>(v), static_cast<V>(w), this->_weight(d)});
+            }
+          }
+        }
+      }
+    }
+
+  private:
+    uint64_t _n;
+    double _radius;
+    uint64_t _seed;
+    E _max_weight;
+    uint64_t _cells;                   // Cells per side.
+    std::vector<uint64_t> _cell_start; // Offsets into _cell_vertices.
+    std::vector<V> _cell_vertices;     // Vertices grouped by cell.
+
+    std::pair<double, double> _position(uint64_t v) const {
+      return {unit(random(this->_seed, 0, v)), unit(random(this->_seed, 1, v))};
+    }
+
+    int64_t _coord(double x) const {
+      return std::min<int64_t>(x * this->_cells, this->_cells - 1);
+    }
+
+    uint64_t _cell(uint64_t v) const {
+      const auto [x, y] = this->_position(v);
+      return this->_coord(x) * this->_cells + this->_coord(y);
+    }
+
+    E _weight(double d) const {
+      const double w = d / this->_radius * this->_max_weight;
+      if constexpr (std::integral<E>) {
+        return std::max<E>(1, static_cast<E>(std::ceil(w)));
+      } else {
+        return static_cast<E>(w);
+      }
+    }
+  };
+
+  // [rows] x [cols] grid with an undirected edge of random weight
+  // between horizontally and vertically adjacent cells. Cell (i, j)
+  // is vertex i*cols + j. Items are vertices, each emitting its edges
+  // to the right and down.
+  template <std::integral V, common::Numeric E>
+  class grid {
+  public:
+    using vertex_type = V;
+    using label_type = E;
+    using edge_type = edge<V, E>;
+    static constexpr bool directed = false;
+
+    grid(uint64_t rows, uint64_t cols, uint64_t seed, E max_weight = 100)
+      : _rows(rows), _cols(cols), _seed(seed), _max_weight(max_weight) {}
+
+    constexpr uint64_t num_vertices() const { return this->_rows * this->_cols; }
+    constexpr uint64_t num_items() const { return this->num_vertices(); }
+
+    // Item [v] is vertex v.
+    void emit(uint64_t v, std::vector<edge_type> &out) const {
+      if (v % this->_cols + 1 < this->_cols) {
+        out.push_back({static_cast<V>(v), static_cast<V>(v + 1),
+                       weight(random(this->_seed, weight_stream, 2 * v), this->_max_weight)});
+      }
+      if (v / this->_cols + 1 < this->_rows) {
+        out.push_back({static_cast<V>(v), static_cast<V>(v + this->_cols),
+                       weight(random(this->_seed, weight_stream, 2 * v + 1), this->_max_weight)});
+      }
+    }
+
+  private:
+    uint64_t _rows;
+    uint64_t _cols;
+    uint64_t _seed;
+    E _max_weight;
+  };
+
+  // Random DAG with [n] vertices and [m] directed edges. Each edge
+  // joins two distinct positions of a hidden topological order, from
+  // the earlier to the later one. The order is an affine permutation
+  // of the vertex ids (p ↦ (a·p + b) mod n with a coprime to n), so
+  // that it doesn't simply coincide with the vertex numbering.
+  template <std::integral V, common::Numeric E>
+  class dag {
+  public:
+    using vertex_type = V;
+    using label_type = E;
+    using edge_type = edge<V, E>;
+    static constexpr bool directed = true;
+
+    dag(uint64_t n, uint64_t m, uint64_t seed, E max_weight = 100)
+      : _n(n), _m(m), _seed(seed), _max_weight(max_weight) {
+      if (n < 2) {
+        throw std::invalid_argument("need at least two vertices");
+      }
+      this->_a = 1 + below(random(seed, 0, ~0ull), n - 1);
+      while (std::gcd(this->_a, n) != 1) {
+        this->_a++;
+      }
+      this->_b = below(random(seed, 1, ~0ull), n);
+    }
+
+    constexpr uint64_t num_vertices() const { return this->_n; }
+    constexpr uint64_t num_items() const { return this->_m; }
+
+    // Vertex at position [p] of the hidden topological order.
+    constexpr V at(uint64_t p) const {
+      return static_cast<V>((static_cast<unsigned __int128>(this->_a) * p + this->_b) % this->_n);
+    }
+
+    // Item [i] is the i-th edge.
+    void emit(uint64_t i, std::vector<edge_type> &out) const {
+      uint64_t p = below(random(this->_seed, 0, i), this->_n);
+      uint64_t q = p;
+      for (uint64_t stream = 1; q == p; stream++) {
+        q = below(random(this->_seed, stream, i), this->_n);
+      }
+      if (q < p) {
+        std::swap(p, q);
+      }
+      out.push_back({this->at(p), this->at(q),
+                     weight(random(this->_seed, weight_stream, i), this->_max_weight)});
+    }
+
+  private:
+    uint64_t _n;
+    uint64_t _m;
+    uint64_t _seed;
+    E _max_weight;
+    uint64_t _a, _b;
+  };
+
+  // Number of items generated per chunk. Chunk boundaries don't
+  // depend on the number of threads, so neither does the output.
+  constexpr uint64_t chunk_size = 1 << 16;
+
+  inline uint default_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // Run generator [g] on [threads] threads, passing the edges of each
+  // chunk to [sink] in order. The sink is only ever called from the
+  // calling thread.
+  template <typename Gen, typename Sink>
+  void generate(const Gen &g, Sink &&sink, uint threads = default_threads()) {
+    using edge_type = typename Gen::edge_type;
+    const uint64_t chunks = (g.num_items() + chunk_size - 1) / chunk_size;
+    threads = std::max(1u, threads);
+    std::vector<std::vector<edge_type>> buffers(threads);
+
+    auto fill = [&g](uint64_t chunk, std::vector<edge_type> &buffer) {
+      buffer.clear();
+      const uint64_t end = std::min(g.num_items(), (chunk + 1) * chunk_size);
+      for (uint64_t i = chunk * chunk_size; i < end; i++) {
+        g.emit(i, buffer);
+      }
+    };
+
+    // Each round generates one chunk per thread and then flushes them
+    // to the sink in order.
+    for (uint64_t first = 0; first < chunks; first += threads) {
+      const uint k = std::min<uint64_t>(threads, chunks - first);
+      {
+        std::vector<std::jthread> workers;
+        for (uint t = 1; t < k; t++) {
+          workers.emplace_back(fill, first + t, std::ref(buffers[t]));
+        }
+        fill(first, buffers[0]);
+      }
+      for (uint t = 0; t < k; t++) {
+        sink(std::span<const edge_type>(buffers[t]));
+      }
+    }
+  }
+
+  // Build the graph described by generator [g] using the bulk
+  // graph::add_edges. Emitted edges are treated as directed or not
+  // according to [directed] (by default, whatever the model is).
+  template <typename Gen>
+  graph<typename Gen::vertex_type, typename Gen::label_type>
+  build(const Gen &g, bool directed = Gen::directed, uint threads = default_threads()) {
+    graph<typename Gen::vertex_type, typename Gen::label_type> result;
+    result.reserve(g.num_vertices());
+    for (uint64_t v = 0; v < g.num_vertices(); v++) {
+      result.add_vertex(static_cast<typename Gen::vertex_type>(v));
+    }
+    generate(g, [&result, directed](std::span<const typename Gen::edge_type> es) {
+      result.add_edges(es, directed);
+    }, threads);
+    return result;
+  }
+
+  // Stream the edges of generator [g] to an edge file at [path]
+  // without building a graph.
+  template <typename Gen>
+  void write(const Gen &g, const std::string &path, uint threads = default_threads()) {
+    edge_file_writer<typename Gen::vertex_type, typename Gen::label_type>
+      writer(path, g.num_vertices());
+    generate(g, writer, threads);
+    writer.close();
+  }
+}
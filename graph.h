@@ -7,6 +7,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <stdexcept>
 #include <unordered_map>
 #include <vector>
 
@@ -14,6 +19,8 @@
 template <typename V, typename E>
 class graph {
 public:
+  using vertex_type = V;
+  using label_type = E;
 
   // Directed edge.
   struct edge {
@@ -23,17 +30,37 @@ public:
     friend bool operator==(const edge&, const edge&) = default;
   };
 
+  // All storage is allocated from memory resource [mr] (the default
+  // resource unless specified otherwise), so a graph can live in an
+  // arena together with the scratch state of the algorithms run on
+  // it (see workspace.h).
+  graph() : graph(std::pmr::get_default_resource()) {}
+
+  explicit graph(std::pmr::memory_resource *mr)
+    : adj(mr), indegree(mr), outdegree(mr) {}
+
+  // Copy of [g] allocated from memory resource [mr].
+  graph(const graph &g, std::pmr::memory_resource *mr)
+    : adj(g.adj, mr), indegree(g.indegree, mr), outdegree(g.outdegree, mr) {}
+
   // Add a vertex to the graph.
   void add_vertex(V v) {
     if (this->adj.contains(v)) {
       throw std::invalid_argument("vertex already in graph");
     } else {
-      this->adj.emplace(v, std::vector<edge>{});
+      this->adj.try_emplace(v);
       this->indegree.emplace(v, 0);
       this->outdegree.emplace(v, 0);
     }
   }
 
+  // Reserve space for [n] vertices.
+  void reserve(uint n) {
+    this->adj.reserve(n);
+    this->indegree.reserve(n);
+    this->outdegree.reserve(n);
+  }
+
   // Add an edge to the graph. If directed=false, a symmetric copy of
   // the edge is also added. If multigraph=false and the edge (or its
   // symmetric copy) already exists, its label is updated with the new
@@ -72,6 +99,24 @@ public:
     this->add_edge({v1, v2, lbl}, directed, multigraph);
   }
 
+  // Add edges [es] in bulk. Like calling add_edge(e, directed, true)
+  // for each of them, but without searching for existing edges, so
+  // the cost is linear in the number of edges.
+  void add_edges(std::span<const edge> es, bool directed=false) {
+    for (const auto &e : es) {
+      if (!this->adj.contains(e.v1)) {
+        throw std::invalid_argument("v1 not in graph");
+      }
+      if (!this->adj.contains(e.v2)) {
+        throw std::invalid_argument("v2 not in graph");
+      }
+      this->_add_edge(e);
+      if (!directed) {
+        this->_add_edge({e.v2, e.v1, e.label});
+      }
+    }
+  }
+
   void remove_edge(const edge &e, bool directed=false) {
     this->_remove_edge(e);
     if (!directed) {
@@ -89,12 +134,25 @@ public:
     return vs;
   }
 
+  // View of all vertices (no copies, no allocation). The view is
+  // invalidated by adding vertices to the graph.
+  auto vertex_view() const {
+    return this->adj | std::views::keys;
+  }
+
   // Get all edges (copies).
   constexpr std::vector<edge> edges(const V &v) const {
-    if (!this->adj.contains(v)) {
-      throw std::invalid_argument("vertex not in graph");
+    const auto es = this->out_edges(v);
+    return std::vector<edge>(es.begin(), es.end());
+  }
+
+  // View of the edges out of [v] (no copies, no allocation). The view
+  // is invalidated by adding or removing edges out of [v].
+  std::span<const edge> out_edges(const V &v) const {
+    if (auto it = this->adj.find(v); it != this->adj.end()) {
+      return it->second;
     }
-    return this->adj.at(v);
+    throw std::invalid_argument("vertex not in graph");
   }
 
   std::vector<edge> all_edges() const {
@@ -119,20 +177,31 @@ public:
     throw std::invalid_argument("edge not in graph");
   }
 
-  // Subgraph induced by vertices [vs].
-  graph<V, E> subgraph(const std::vector<V> &vs) {
+  // Subgraph induced by vertices [vs] (a copy; see subgraph_view.h
+  // for views that filter without copying).
+  graph<V, E> subgraph(const std::vector<V> &vs) const {
     graph<V, E> g;
     for (const auto &v : vs) {
       g.add_vertex(v);
     }
     for (const auto &v : vs) {
-      for (const auto &e : this->edges[v]) {
-        g.add_edge(e, true, true);
+      for (const auto &e : this->out_edges(v)) {
+        if (g.contains(e.v2)) {
+          g.add_edge(e, true, true);
+        }
       }
     }
     return g;
   }
 
+  bool contains(const V &v) const {
+    return this->adj.contains(v);
+  }
+
+  constexpr uint num_vertices() const {
+    return this->adj.size();
+  }
+
   constexpr uint in_degree(const V &v) const {
     if (this->indegree.contains(v)) {
       return this->indegree.at(v);
@@ -146,9 +215,9 @@ public:
   }
 
 private:
-  std::unordered_map<V, std::vector<edge>> adj;
-  std::unordered_map<V, uint> indegree;
-  std::unordered_map<V, uint> outdegree;
+  std::pmr::unordered_map<V, std::pmr::vector<edge>> adj;
+  std::pmr::unordered_map<V, uint> indegree;
+  std::pmr::unordered_map<V, uint> outdegree;
 
   // Primitive operation for adding a single directed edge. Undirected
   // edges are implemented (by, e.g., public method 'add_edge') by
@@ -0,0 +1,217 @@
+// Persistent (immutable) hash map: a hash array mapped trie (Bagwell).
+// Each level of the trie consumes 5 bits of the key's hash, and each
+// node stores only its present children, packed in an array indexed by
+// the popcount of a 32-bit bitmap. Updates return a new map that
+// copies the O(log32 n) nodes on the path to the key and shares the
+// rest with the old one, so copying a map is O(1) (a pointer copy) and
+// old versions stay valid and unchanged. Nodes are reference counted,
+// so they're freed when no version uses them anymore.
+//
+// Keys whose hashes collide entirely end up in a list at the bottom of
+// the trie.
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <variant>
+#include <vector>
+
+template <typename K, typename T, typename Hash = std::hash<K>>
+class hamt {
+public:
+  hamt() {}
+
+  constexpr uint size() const {
+    return this->_size;
+  }
+
+  constexpr bool empty() const {
+    return this->_size == 0;
+  }
+
+  // Value of key [k], or null if it isn't in the map. The pointer
+  // stays valid as long as some version holding it is alive.
+  const T *find(const K &k) const {
+    const std::size_t h = Hash{}(k);
+    const node *n = this->_root.get();
+    for (uint shift = 0; n; shift += bits) {
+      if (shift >= hash_bits) {
+        for (const auto &l : n->collisions) {
+          if (l.key == k) {
+            return &l.value;
+          }
+        }
+        return nullptr;
+      }
+      const uint32_t bit = uint32_t{1} << ((h >> shift) & mask);
+      if (!(n->bitmap & bit)) {
+        return nullptr;
+      }
+      const auto &slot = n->slots[std::popcount(n->bitmap & (bit - 1))];
+      if (const leaf *l = std::get_if<leaf>(&slot)) {
+        return l->key == k ? &l->value : nullptr;
+      }
+      n = std::get<node_ptr>(slot).get();
+    }
+    return nullptr;
+  }
+
+  bool contains(const K &k) const {
+    return this->find(k) != nullptr;
+  }
+
+  // Map with key [k] set to [value] (added or replaced).
+  [[nodiscard]] hamt set(const K &k, T value) const {
+    auto [root, added] = _set(this->_root.get(), Hash{}(k), k, std::move(value), 0);
+    return hamt(std::move(root), this->_size + added);
+  }
+
+  // Map without key [k] (the same map if it isn't there).
+  [[nodiscard]] hamt erase(const K &k) const {
+    auto [root, removed] = _erase(this->_root, Hash{}(k), k, 0);
+    return removed ? hamt(std::move(root), this->_size - 1) : *this;
+  }
+
+  // Call [f](key, value) on each entry (in no particular order).
+  template <typename F>
+  void for_each(F f) const {
+    _for_each(this->_root.get(), f);
+  }
+
+  // Whether [other] is literally the same version (shares the root).
+  bool same(const hamt &other) const {
+    return this->_root == other._root;
+  }
+
+private:
+  static constexpr uint bits = 5;
+  static constexpr uint mask = (1 << bits) - 1;
+  static constexpr uint hash_bits = 8 * sizeof(std::size_t);
+
+  struct leaf {
+    std::size_t hash;
+    K key;
+    T value;
+  };
+
+  struct node;
+  using node_ptr = std::shared_ptr<const node>;
+
+  struct node {
+    uint32_t bitmap = 0;
+    std::vector<std::variant<leaf, node_ptr>> slots; // In bit order.
+    std::vector<leaf> collisions;                    // Below the last level.
+  };
+
+  node_ptr _root;
+  uint _size = 0;
+
+  hamt(node_ptr root, uint size) : _root(std::move(root)), _size(size) {}
+
+  // Copy of node [n] (or a new node if null) with [k] set to [value],
+  // and whether [k] was added.
+  static std::pair<node_ptr, bool> _set(const node *n, std::size_t h, const K &k,
+                                        T value, uint shift) {
+    auto copy = n ? std::make_shared<node>(*n) : std::make_shared<node>();
+    if (shift >= hash_bits) {
+      for (auto &l : copy->collisions) {
+        if (l.key == k) {
+          l.value = std::move(value);
+          return {copy, false};
+        }
+      }
+      copy->collisions.push_back({h, k, std::move(value)});
+      return {copy, true};
+    }
+
+    const uint32_t bit = uint32_t{1} << ((h >> shift) & mask);
+    const uint pos = std::popcount(copy->bitmap & (bit - 1));
+    if (!(copy->bitmap & bit)) {
+      copy->slots.insert(copy->slots.begin() + pos, leaf{h, k, std::move(value)});
+      copy->bitmap |= bit;
+      return {copy, true};
+    }
+
+    auto &slot = copy->slots[pos];
+    if (leaf *l = std::get_if<leaf>(&slot)) {
+      if (l->key == k) {
+        l->value = std::move(value);
+        return {copy, false};
+      }
+      // Push the existing leaf down a level, next to the new one.
+      const node_ptr sub = _set(nullptr, l->hash, l->key, std::move(l->value), shift + bits).first;
+      slot = _set(sub.get(), h, k, std::move(value), shift + bits).first;
+      return {copy, true};
+    }
+    auto [sub, added] = _set(std::get<node_ptr>(slot).get(), h, k, std::move(value), shift + bits);
+    slot = std::move(sub);
+    return {copy, added};
+  }
+
+  // Node [n] without [k] (null if that leaves it empty), and whether
+  // [k] was there.
+  static std::pair<node_ptr, bool> _erase(const node_ptr &n, std::size_t h, const K &k,
+                                          uint shift) {
+    if (!n) {
+      return {n, false};
+    }
+    if (shift >= hash_bits) {
+      for (uint i = 0; i < n->collisions.size(); i++) {
+        if (n->collisions[i].key == k) {
+          auto copy = std::make_shared<node>(*n);
+          copy->collisions.erase(copy->collisions.begin() + i);
+          return {copy->collisions.empty() ? nullptr : node_ptr(copy), true};
+        }
+      }
+      return {n, false};
+    }
+
+    const uint32_t bit = uint32_t{1} << ((h >> shift) & mask);
+    if (!(n->bitmap & bit)) {
+      return {n, false};
+    }
+    const uint pos = std::popcount(n->bitmap & (bit - 1));
+    node_ptr sub;
+    if (const leaf *l = std::get_if<leaf>(&n->slots[pos])) {
+      if (l->key != k) {
+        return {n, false};
+      }
+    } else {
+      bool removed;
+      std::tie(sub, removed) = _erase(std::get<node_ptr>(n->slots[pos]), h, k, shift + bits);
+      if (!removed) {
+        return {n, false};
+      }
+    }
+
+    auto copy = std::make_shared<node>(*n);
+    if (sub) {
+      copy->slots[pos] = std::move(sub);
+    } else {
+      copy->slots.erase(copy->slots.begin() + pos);
+      copy->bitmap &= ~bit;
+    }
+    return {copy->slots.empty() ? nullptr : node_ptr(copy), true};
+  }
+
+  template <typename F>
+  static void _for_each(const node *n, F &f) {
+    if (!n) {
+      return;
+    }
+    for (const auto &slot : n->slots) {
+      if (const leaf *l = std::get_if<leaf>(&slot)) {
+        f(l->key, l->value);
+      } else {
+        _for_each(std::get<node_ptr>(slot).get(), f);
+      }
+    }
+    for (const auto &l : n->collisions) {
+      f(l.key, l.value);
+    }
+  }
+};
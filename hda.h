@@ -0,0 +1,235 @@
+// Hash-distributed A* (Kishimoto, Fukunaga & Botea, "Scalable,
+// Parallel Best-First Search for Optimal Sequential Planning"): a
+// single A* query spread over several threads. Each vertex is owned by
+// one thread, chosen by hashing it, and only its owner keeps its
+// tentative distance and predecessor and expands it, from the owner's
+// own open list. Relaxing an edge to a vertex owned by another thread
+// sends it the new distance through that thread's lock-free inbox (see
+// mpsc_queue.h), in batches to keep the traffic down.
+//
+// Threads don't expand in global f order, so the first path found to
+// the destination needn't be the shortest. It's kept as the incumbent
+// instead, and the search goes on, pruning every vertex whose f score
+// is no better, until no thread has anything left to expand and no
+// message is in flight. With an admissible heuristic whatever could
+// still improve the incumbent is never pruned, so the final incumbent
+// is optimal. Quiescence is detected with a single counter of active
+// threads plus messages in flight: a message is counted before it's
+// sent and uncounted only after its receiver has counted itself as
+// active again, so the counter can't reach zero while work remains.
+//
+// This pays off when expansions are expensive (costly heuristics,
+// large degrees) or the query is long; on cheap expansions the
+// messaging overhead eats most of the parallelism. The graph and the
+// heuristic are used from all the threads at once, so both must be
+// safe to read concurrently ('graph', 'compact_graph' and
+// 'alt_landmarks' are).
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "astar.h"
+#include "common.h"
+#include "graph.h"
+#include "mpsc_queue.h"
+
+namespace hda {
+
+  inline uint default_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // Number of messages to a thread buffered before they're sent.
+  constexpr std::size_t batch_size = 64;
+
+  // Find the shortest path in [g] from [src] to [dest] on [threads]
+  // threads using heuristic function [h] (which must be admissible,
+  // and is called from all the threads).
+  template <common::WeightedGraph G>
+  std::vector<common::edge_t<G>> shortest_path(const G &g,
+                                               const common::vertex_t<G> &src,
+                                               const common::vertex_t<G> &dest,
+                                               const astar::heuristic<G> &h,
+                                               uint threads = default_threads()) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    if (!g.contains(src)) {
+      throw std::invalid_argument("source doesn't exist");
+    }
+    threads = std::max(1u, threads);
+
+    // A vertex reached with distance 'dist' through 'pred'.
+    struct message {
+      V v;
+      E dist;
+      V pred;
+    };
+
+    using item = std::tuple<E, E, V>; // f score, distance, vertex.
+
+    struct alignas(64) worker {
+      mpsc_queue<std::vector<message>> inbox;
+      std::atomic<uint> wakeups = 0; // Bumped (and notified) on new mail.
+      std::priority_queue<item, std::vector<item>, std::greater<item>> open;
+      std::unordered_map<V, E> dist;
+      std::unordered_map<V, V> pred;
+      std::vector<std::vector<message>> out; // Per destination thread.
+    };
+    std::vector<worker> workers(threads);
+
+    auto owner = [threads](const V &v) {
+      // Mix the hash, since e.g. integers hash to themselves.
+      uint64_t x = std::hash<V>{}(v);
+      x ^= x >> 33;
+      x *= 0xff51afd7ed558ccdULL;
+      x ^= x >> 33;
+      return static_cast<uint>(x % threads);
+    };
+
+    constexpr E infinity = std::numeric_limits<E>::max();
+    std::atomic<E> incumbent = infinity;
+    // Active threads plus messages in flight.
+    std::atomic<uint64_t> active = threads;
+
+    {
+      worker &w = workers[owner(src)];
+      w.dist[src] = 0;
+      w.open.push({h(src), 0, src});
+    }
+
+    auto run = [&](uint t) {
+      worker &self = workers[t];
+      self.out.resize(threads);
+
+      // Record distance [d] to [v] (owned by this thread) through [p],
+      // if it's an improvement worth expanding.
+      auto relax = [&](const V &v, E d, const V &p) {
+        auto it = self.dist.find(v);
+        if (it != self.dist.end() && it->second <= d) {
+          return;
+        }
+        const E f = d + h(v);
+        if (f >= incumbent.load(std::memory_order_relaxed)) {
+          return;
+        }
+        self.dist[v] = d;
+        self.pred[v] = p;
+        self.open.push({f, d, v});
+      };
+
+      auto receive = [&]() {
+        return self.inbox.drain([&](std::vector<message> &&ms) {
+          for (const auto &m : ms) {
+            relax(m.v, m.dist, m.pred);
+          }
+          active.fetch_sub(1);
+        });
+      };
+
+      auto wake = [&](uint to) {
+        workers[to].wakeups.fetch_add(1);
+        workers[to].wakeups.notify_one();
+      };
+
+      auto send = [&](uint to) {
+        if (!self.out[to].empty()) {
+          active.fetch_add(1);
+          workers[to].inbox.push(std::move(self.out[to]));
+          self.out[to].clear();
+          wake(to);
+        }
+      };
+
+      for (;;) {
+        receive();
+
+        // Expand a few vertices between checks of the inbox.
+        for (uint i = 0; i < batch_size && !self.open.empty(); i++) {
+          const auto [f, d, u] = self.open.top();
+          self.open.pop();
+          if (d > self.dist.at(u) || f >= incumbent.load(std::memory_order_relaxed)) {
+            continue;
+          }
+          if (u == dest) {
+            E cur = incumbent.load();
+            while (d < cur && !incumbent.compare_exchange_weak(cur, d)) {}
+            continue;
+          }
+          for (const auto &e : g.out_edges(u)) {
+            const E dv = d + e.label;
+            const uint to = owner(e.v2);
+            if (to == t) {
+              relax(e.v2, dv, u);
+            } else {
+              self.out[to].push_back({e.v2, dv, u});
+              if (self.out[to].size() >= batch_size) {
+                send(to);
+              }
+            }
+          }
+        }
+
+        for (uint to = 0; to < threads; to++) {
+          send(to);
+        }
+        if (!self.open.empty()) {
+          continue;
+        }
+
+        // Out of work (and everything sent): sleep until there's more
+        // or everyone is done. The last one to finish wakes the others.
+        if (active.fetch_sub(1) == 1) {
+          for (uint to = 0; to < threads; to++) {
+            wake(to);
+          }
+        }
+        for (;;) {
+          const uint seen = self.wakeups.load();
+          if (!self.inbox.empty()) {
+            active.fetch_add(1);
+            break;
+          }
+          if (active.load() == 0) {
+            return;
+          }
+          self.wakeups.wait(seen);
+        }
+      }
+    };
+
+    {
+      std::vector<std::jthread> pool;
+      for (uint t = 1; t < threads; t++) {
+        pool.emplace_back(run, t);
+      }
+      run(0);
+    }
+
+    if (incumbent.load() == infinity) {
+      // If the search finished without reaching the destination, then
+      // it must not have existed in the graph.
+      throw std::invalid_argument("destination doesn't exist");
+    }
+
+    // Collect the predecessors along the path from their owners.
+    std::unordered_map<V, V> pred;
+    for (V v = dest; v != src; ) {
+      const V p = workers[owner(v)].pred.at(v);
+      pred[v] = p;
+      v = p;
+    }
+    return common::build_path(g, pred, src, dest);
+  }
+}
@@ -0,0 +1,110 @@
+// Hot-path instrumentation counters. Algorithms take an optional
+// trailing policy argument (after the memory resource), which is
+// 'instrument::none' by default. Its member functions are all empty,
+// so the instrumentation compiles to nothing. Passing an
+// 'instrument::stats' instead adds the counts of that call to it:
+//
+//   instrument::stats s;
+//   dijkstra::shortest_path2(g, src, dest, std::pmr::get_default_resource(), s);
+//   std::cout << s.settled << " " << s.decrease_keys << std::endl;
+//
+// Counts are added to (not reset), so one 'stats' can aggregate many
+// calls.
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace instrument {
+
+  // Counting policy.
+  struct stats {
+    static constexpr bool enabled = true;
+
+    uint64_t settled = 0;         // Vertices settled/visited.
+    uint64_t relaxed = 0;         // Edges relaxed/examined.
+    uint64_t heap_inserts = 0;    // Insertions into the open set.
+    uint64_t decrease_keys = 0;   // Decrease-key operations.
+    uint64_t extracts = 0;        // Extract-min operations.
+    uint64_t uf_finds = 0;        // Union-find 'find' operations.
+    uint64_t uf_path_length = 0;  // Parent links followed by them.
+    uint64_t bytes_allocated = 0; // Scratch memory allocated.
+
+    void settle() { this->settled++; }
+    void relax() { this->relaxed++; }
+    void heap_insert() { this->heap_inserts++; }
+    void decrease_key() { this->decrease_keys++; }
+    void extract() { this->extracts++; }
+    void uf_find(uint64_t length) {
+      this->uf_finds++;
+      this->uf_path_length += length;
+    }
+    void allocate(std::size_t bytes) { this->bytes_allocated += bytes; }
+  };
+
+  // Non-counting policy.
+  struct none {
+    static constexpr bool enabled = false;
+
+    void settle() {}
+    void relax() {}
+    void heap_insert() {}
+    void decrease_key() {}
+    void extract() {}
+    void uf_find(uint64_t) {}
+    void allocate(std::size_t) {}
+  };
+
+  // Default policy argument.
+  inline none off;
+
+  template <typename S>
+  concept Policy = requires(S &s) {
+    { S::enabled } -> std::convertible_to<bool>;
+    s.settle();
+    s.relax();
+    s.heap_insert();
+    s.decrease_key();
+    s.extract();
+    s.uf_find(0);
+    s.allocate(0);
+  };
+
+  // Memory resource forwarding to [upstream] and recording the bytes
+  // allocated through it in policy [s]. Algorithms allocate from
+  // 'get()', which is just [upstream] when the policy is disabled.
+  template <Policy S>
+  class resource : public std::pmr::memory_resource {
+  public:
+    resource(std::pmr::memory_resource *upstream, S &s)
+      : _upstream(upstream), _stats(s) {}
+
+    std::pmr::memory_resource *get() {
+      if constexpr (S::enabled) {
+        return this;
+      } else {
+        return this->_upstream;
+      }
+    }
+
+  private:
+    std::pmr::memory_resource *_upstream;
+    S &_stats;
+
+    void *do_allocate(std::size_t bytes, std::size_t align) override {
+      this->_stats.allocate(bytes);
+      return this->_upstream->allocate(bytes, align);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t align) override {
+      this->_upstream->deallocate(p, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &r) const noexcept override {
+      return this == &r;
+    }
+  };
+}
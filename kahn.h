@@ -4,6 +4,7 @@
 #pragma once
 
 #include <ranges>
+#include <unordered_map>
 #include <vector>
 
 #include "common.h"
@@ -13,24 +14,30 @@ namespace views = std::ranges::views;
 
 namespace kahn {
 
-  template <typename V, typename E>
-  std::vector<V> topsort(const graph<V, E> &g) {
-    // Create copy of the graph.
-    graph<V, E> g2(g);
+  // Works on any graph type (see common::Graph), including views like
+  // 'subgraph_view'. The graph isn't copied: we count the in-degrees
+  // up front and decrement them instead of removing edges.
+  template <common::Graph G>
+  std::vector<common::vertex_t<G>> topsort(const G &g) {
+    using V = common::vertex_t<G>;
+
+    // In-degree of each vertex.
+    std::unordered_map<V, uint> indegree;
+    indegree.reserve(g.num_vertices());
+    for (const auto &v : g.vertex_view()) {
+      indegree.try_emplace(v, 0);
+      for (const auto &e : g.out_edges(v)) {
+        indegree[e.v2]++;
+      }
+    }
 
     // Vector of topologically sorted vertices. Initially empty.
     std::vector<V> vertices;
 
     // Find vertices with no incoming edges.
-    // This is unfortunately strange and annoying compared to the
-    // corresponding code in Rust. I would probably favor just writing
-    // a simple loop instead. I'm not sure at the moment why we must
-    // declare the variable vs instead of using 'g.vertices()'
-    // directly on the LHS of the '|' operator. Presumably it has to
-    // be an l-value, but I don't know why.
-    const std::vector<V> vs = g.vertices();
-    std::vector<V> no_inc = common::collect<V>(vs | views::filter([g](const V &v) {
-      return g.in_degree(v) == 0;
+    auto vs = g.vertex_view();
+    std::vector<V> no_inc = common::collect<V>(vs | views::filter([&indegree](const V &v) {
+      return indegree.at(v) == 0;
     }));
     // In C++23 we should be able to do this instead of our custom
     // 'collect' function.
@@ -45,11 +52,10 @@ namespace kahn {
       // Add it to the end of our vector of topologically sorted vertices.
       vertices.push_back(v);
 
-      // Delete the edges coming out of v. If this reduces the
+      // "Delete" the edges coming out of v. If this reduces the
       // indegree of any vertex to 0 then add it to 'no_inc'.
-      for (const auto &e : g2.edges(v)) {
-        g2.remove_edge(e, true);
-        if (g2.in_degree(e.v2) == 0) {
+      for (const auto &e : g.out_edges(v)) {
+        if (--indegree.at(e.v2) == 0) {
           no_inc.push_back(e.v2);
         }
       }
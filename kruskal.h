@@ -2,34 +2,60 @@
 
 #pragma once
 
+#include <algorithm>
+#include <iterator>
+#include <memory_resource>
 #include <vector>
 
 #include "common.h"
 #include "graph.h"
+#include "instrument.h"
+#include "sort.h"
 #include "union_find.h"
 
 namespace kruskal {
-  template <typename V, common::Numeric E>
-  std::vector<edge<V, E>> mst(const graph<V, E> &g) {
-    union_find<V> uf;
+
+  // All scratch state is allocated from memory resource [mr] (see
+  // workspace.h), and operation counts are recorded by instrumentation
+  // policy [stats] (see instrument.h).
+  template <common::WeightedGraph G,
+            instrument::Policy S = instrument::none>
+  std::vector<common::edge_t<G>> mst(const G &g,
+                                     std::pmr::memory_resource *mr =
+                                     std::pmr::get_default_resource(),
+                                     S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    // Count scratch allocations (when instrumented).
+    instrument::resource<S> counted(mr, stats);
+    mr = counted.get();
+
+    union_find<V> uf(mr);
     std::vector<edge<V, E>> ms_forest;
 
-    for (const auto &v : g.vertices()) {
+    uf.reserve(g.num_vertices());
+    for (const auto &v : g.vertex_view()) {
       uf.add(v);
     }
 
-    auto edges = g.all_edges();
-    std::sort(edges.begin(), edges.end(), [](const edge<V, E> &a,
-                                             const edge<V, E> &b) {
-      return a.label < b.label;
+    std::pmr::vector<edge<V, E>> edges(mr);
+    for (const auto &v : g.vertex_view()) {
+      std::ranges::copy(g.out_edges(v), std::back_inserter(edges));
+    }
+    // Sorting the edges dominates the running time, so we use a radix
+    // sort by label rather than a comparison sort.
+    sort::radix_sort(edges, [](const edge<V, E> &e) {
+      return e.label;
     });
 
     for (const auto &e : edges) {
-      auto v1_set = uf.find(e.v1);
-      auto v2_set = uf.find(e.v2);
+      stats.relax();
+      auto v1_set = uf.find(e.v1, stats);
+      auto v2_set = uf.find(e.v2, stats);
       if (v1_set != v2_set) {
         ms_forest.push_back(e);
-        uf.set_union(v1_set, v2_set);
+        uf.set_union(v1_set, v2_set, stats);
       }
     }
 
@@ -0,0 +1,192 @@
+// K shortest loopless paths (Yen's algorithm). Each path after the
+// first is found by deviating from the previous one: for every vertex
+// along it (the 'spur' vertex), search for the shortest path from
+// there to the destination that avoids the path's earlier vertices
+// and the next edges taken by the already-found paths sharing the
+// same prefix. The best candidate over all deviations (and earlier
+// rounds) is the next path. The spur searches run in parallel with
+// 'dijkstra::shortest_path_masked', which skips the excluded
+// vertices and edges without copying the graph. They're guided by
+// the distances to the destination in the unmasked graph (computed
+// once, by a search backward from the destination), which are lower
+// bounds on the masked distances, so each search only explores
+// around the best deviation instead of the whole graph.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <set>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "common.h"
+#include "dijkstra.h"
+#include "graph.h"
+#include "workspace.h"
+
+namespace ksp {
+
+  inline uint default_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // Up to [k] shortest loopless paths in [g] from [src] to [dest], in
+  // order of increasing weight (ties broken by comparing the vertex
+  // sequences, so the result is deterministic). The edges of the
+  // paths are labeled by their weights. Throws if [dest] is
+  // unreachable.
+  template <typename V, common::Numeric E>
+  requires std::totally_ordered<V>
+  std::vector<std::vector<edge<V, E>>> yen(const graph<V, E> &g,
+                                           const V &src,
+                                           const V &dest,
+                                           uint k,
+                                           uint threads = default_threads()) {
+    using path = std::vector<edge<V, E>>;
+
+    auto weight = [](const path &p) {
+      E w = static_cast<E>(0);
+      for (const auto &e : p) {
+        w += e.label;
+      }
+      return w;
+    };
+
+    auto vertices = [&src](const path &p) {
+      std::vector<V> vs = {src};
+      for (const auto &e : p) {
+        vs.push_back(e.v2);
+      }
+      return vs;
+    };
+
+    // Candidate paths, ordered by weight and then by vertices (which
+    // also deduplicates them).
+    struct candidate {
+      E weight;
+      std::vector<V> vertices;
+      path edges;
+
+      bool operator<(const candidate &other) const {
+        if (this->weight != other.weight) {
+          return this->weight < other.weight;
+        }
+        return this->vertices < other.vertices;
+      }
+    };
+
+    std::vector<path> result;
+    std::vector<std::vector<V>> result_vertices;
+    std::set<candidate> candidates;
+
+    if (k == 0) {
+      return result;
+    }
+
+    // Distance from each vertex to the destination (vertices that
+    // can't reach it are missing).
+    graph<V, E> reversed;
+    std::vector<edge<V, E>> es;
+    for (const auto &v : g.vertex_view()) {
+      reversed.add_vertex(v);
+      for (const auto &e : g.out_edges(v)) {
+        es.push_back({e.v2, e.v1, e.label});
+      }
+    }
+    reversed.add_edges(es, true);
+    if (!reversed.contains(dest)) {
+      throw std::invalid_argument("destination doesn't exist");
+    }
+    const auto to_dest = dijkstra::tree(reversed, dest).dist;
+    auto potential = [&to_dest](const V &v) {
+      return to_dest.at(v);
+    };
+    auto dead_end = [&to_dest](const V &v) {
+      return !to_dest.contains(v);
+    };
+
+    if (!g.contains(src) || dead_end(src)) {
+      throw std::invalid_argument("destination unreachable");
+    }
+    auto first = dijkstra::shortest_path_masked(g, src, dest, dead_end,
+                                                [](const edge<V, E>&) { return false; },
+                                                potential);
+    result.push_back(std::move(first.value()));
+    result_vertices.push_back(vertices(result.back()));
+
+    threads = std::max(1u, threads);
+    while (result.size() < k) {
+      const path &prev = result.back();
+      const std::vector<V> &prev_vs = result_vertices.back();
+
+      // Spur search from the i-th vertex of the previous path, giving
+      // the full candidate path (if there is one).
+      auto spur = [&](uint i, std::pmr::memory_resource *mr) -> std::optional<candidate> {
+        const V &spur_v = prev_vs[i];
+
+        // Edges leaving the spur vertex taken by found paths with the
+        // same root (the part of the path up to the spur vertex).
+        std::unordered_set<V> next;
+        for (const auto &vs : result_vertices) {
+          if (vs.size() > i + 1 && std::equal(prev_vs.begin(), prev_vs.begin() + i + 1,
+                                              vs.begin())) {
+            next.insert(vs[i + 1]);
+          }
+        }
+        std::unordered_set<V> root(prev_vs.begin(), prev_vs.begin() + i);
+
+        auto spur_path = dijkstra::shortest_path_masked(
+          g, spur_v, dest,
+          [&root, &dead_end](const V &v) { return dead_end(v) || root.contains(v); },
+          [&spur_v, &next](const edge<V, E> &e) {
+            return e.v1 == spur_v && next.contains(e.v2);
+          },
+          potential, mr);
+        if (!spur_path.has_value()) {
+          return {};
+        }
+        path p(prev.begin(), prev.begin() + i);
+        p.insert(p.end(), spur_path->begin(), spur_path->end());
+        return candidate{weight(p), vertices(p), std::move(p)};
+      };
+
+      // Run the spur searches, spreading them over the threads (each
+      // with its own scratch memory).
+      const uint n = prev.size();
+      std::vector<std::optional<candidate>> found(n);
+      std::atomic<uint> next_i = 0;
+      auto work = [&]() {
+        workspace ws;
+        for (uint i; (i = next_i++) < n;) {
+          found[i] = spur(i, ws.rewind());
+        }
+      };
+      {
+        std::vector<std::jthread> workers;
+        for (uint t = 1; t < std::min(threads, n); t++) {
+          workers.emplace_back(work);
+        }
+        work();
+      }
+
+      for (auto &c : found) {
+        if (c.has_value() &&
+            std::find(result_vertices.begin(), result_vertices.end(),
+                      c->vertices) == result_vertices.end()) {
+          candidates.insert(std::move(c.value()));
+        }
+      }
+      if (candidates.empty()) {
+        break;
+      }
+      auto best = candidates.extract(candidates.begin());
+      result.push_back(std::move(best.value().edges));
+      result_vertices.push_back(std::move(best.value().vertices));
+    }
+
+    return result;
+  }
+}
@@ -108,14 +108,11 @@ int main() {
   }
   cout << sum << endl;
 
-  // Solve with Dijkstra's algorithm.
-  const auto path1 = dijkstra::shortest_path2(g, src, dest);
-  // Compute path sum.
-  sum = matrix[0][0];
-  for (const auto &e : path1) {
-    sum += matrix[e.v2 / 80][e.v2 % 80];
-  }
-  cout << sum << endl;
+  // Solve with Dijkstra's algorithm. Edges are labeled by their
+  // source cell, so the path's distance counts every cell but the
+  // last.
+  const auto path1 = dijkstra::shortest_path_result(g, src, dest);
+  cout << path1.distance() + matrix[dest / 80][dest % 80] << endl;
 
   // Solve with A*.
   std::function<int(const int&)> h = [](const int &v) {
@@ -0,0 +1,62 @@
+// Lock-free multi-producer single-consumer queue. Producers push onto
+// an intrusive linked stack with a compare-and-swap on its head, and
+// the consumer takes everything pushed so far at once by swapping the
+// head with null, so neither side ever waits on the other and there's
+// no ABA problem (nodes are only ever removed all together, by the one
+// consumer). The values taken at once come out newest first, so the
+// queue is only FIFO between takes: fine for work distribution, where
+// the order within a batch doesn't matter.
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+template <typename T>
+class mpsc_queue {
+public:
+  mpsc_queue() {}
+
+  mpsc_queue(const mpsc_queue&) = delete;
+  mpsc_queue &operator=(const mpsc_queue&) = delete;
+
+  ~mpsc_queue() {
+    this->drain([](T&&) {});
+  }
+
+  // Push [value] (from any thread).
+  void push(T value) {
+    node *n = new node{std::move(value), this->_head.load(std::memory_order_relaxed)};
+    while (!this->_head.compare_exchange_weak(n->next, n, std::memory_order_release,
+                                              std::memory_order_relaxed)) {}
+  }
+
+  // Call [f] on (and remove) every value pushed so far, newest first
+  // (from the consumer thread only). Returns false if there were none.
+  template <typename F>
+  bool drain(F f) {
+    node *n = this->_head.exchange(nullptr, std::memory_order_acquire);
+    if (!n) {
+      return false;
+    }
+    while (n) {
+      node *next = n->next;
+      f(std::move(n->value));
+      delete n;
+      n = next;
+    }
+    return true;
+  }
+
+  bool empty() const {
+    return this->_head.load(std::memory_order_acquire) == nullptr;
+  }
+
+private:
+  struct node {
+    T value;
+    node *next;
+  };
+
+  std::atomic<node*> _head = nullptr;
+};
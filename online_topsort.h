@@ -0,0 +1,200 @@
+// Online topological ordering (Pearce and Kelly). Owns a DAG and a
+// topological order of its vertices, and keeps the order valid as
+// edges are added. Adding edge x -> y when x already comes before y
+// costs nothing. Otherwise only the vertices between y and x in the
+// order can be affected: a forward search from y and a backward
+// search from x (both confined to that region) find the ones that
+// have to move, and they're shuffled among their own positions. If
+// the forward search reaches x, the edge would close a cycle, so it's
+// rejected with a 'cycle_error' carrying the cycle.
+
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "graph.h"
+#include "kahn.h"
+
+// Thrown when adding an edge would create a cycle. [cycle] is the
+// cycle the edge would close, starting with the edge: [x, y, ..., z]
+// for the edges x -> y -> ... -> z -> x.
+template <typename V>
+class cycle_error : public std::invalid_argument {
+public:
+  explicit cycle_error(std::vector<V> cycle)
+    : std::invalid_argument("edge would create a cycle"), cycle(std::move(cycle)) {}
+
+  std::vector<V> cycle;
+};
+
+template <typename V, typename E>
+class online_topsort {
+public:
+  online_topsort() {}
+
+  // Start with (a copy of) DAG [g] (throws 'cycle_error' if it isn't
+  // acyclic).
+  explicit online_topsort(const graph<V, E> &g) {
+    for (const auto &v : kahn::topsort(g)) {
+      this->add_vertex(v);
+    }
+    if (this->_order.size() == g.num_vertices()) {
+      std::vector<edge<V, E>> es, rs;
+      for (const auto &v : g.vertex_view()) {
+        for (const auto &e : g.out_edges(v)) {
+          es.push_back(e);
+          rs.push_back({e.v2, e.v1, e.label});
+        }
+      }
+      this->_g.add_edges(es, true);
+      this->_rev.add_edges(rs, true);
+    } else {
+      // Not acyclic. Add the edges one at a time to find a cycle.
+      for (const auto &v : g.vertex_view()) {
+        this->add_vertex(v);
+      }
+      for (const auto &v : g.vertex_view()) {
+        for (const auto &e : g.out_edges(v)) {
+          this->add_edge(e);
+        }
+      }
+    }
+  }
+
+  // Add vertex [v] at the end of the order (does nothing if it
+  // already exists).
+  void add_vertex(const V &v) {
+    if (!this->_g.contains(v)) {
+      this->_g.add_vertex(v);
+      this->_rev.add_vertex(v);
+      this->_ord[v] = this->_order.size();
+      this->_order.push_back(v);
+    }
+  }
+
+  // Add edge [e] (missing vertices are added), reordering the
+  // affected vertices if necessary. Throws 'cycle_error' (leaving
+  // everything unchanged) if it would create a cycle.
+  void add_edge(const edge<V, E> &e) {
+    this->add_vertex(e.v1);
+    this->add_vertex(e.v2);
+    const V &x = e.v1, &y = e.v2;
+    if (x == y) {
+      throw cycle_error<V>({x});
+    }
+
+    const uint lb = this->_ord.at(y);
+    const uint ub = this->_ord.at(x);
+    if (lb < ub) {
+      // Vertices reachable from y (up to x's position).
+      std::vector<V> forward;
+      std::unordered_map<V, V> parent;
+      std::vector<V> stack = {y};
+      parent[y] = y;
+      while (!stack.empty()) {
+        const V v = stack.back();
+        stack.pop_back();
+        forward.push_back(v);
+        for (const auto &f : this->_g.out_edges(v)) {
+          const uint o = this->_ord.at(f.v2);
+          if (o == ub) {
+            // Reached x: the cycle is x -> y -> ... -> v -> x.
+            std::vector<V> cycle = {x};
+            for (V w = v; w != y; w = parent.at(w)) {
+              cycle.push_back(w);
+            }
+            cycle.push_back(y);
+            std::reverse(cycle.begin() + 1, cycle.end());
+            throw cycle_error<V>(std::move(cycle));
+          }
+          if (o < ub && parent.try_emplace(f.v2, v).second) {
+            stack.push_back(f.v2);
+          }
+        }
+      }
+
+      // Vertices reaching x (down to y's position).
+      std::vector<V> backward;
+      std::unordered_set<V> seen = {x};
+      stack = {x};
+      while (!stack.empty()) {
+        const V v = stack.back();
+        stack.pop_back();
+        backward.push_back(v);
+        for (const auto &f : this->_rev.out_edges(v)) {
+          if (this->_ord.at(f.v2) > lb && seen.insert(f.v2).second) {
+            stack.push_back(f.v2);
+          }
+        }
+      }
+
+      // Move the backward set in front of the forward set, keeping
+      // the relative order within each, and reusing their positions.
+      this->_reorder(backward, forward);
+    }
+
+    this->_g.add_edge(e, true);
+    this->_rev.add_edge({y, x, e.label}, true);
+  }
+
+  void add_edge(const V &v1, const V &v2, const E &lbl) {
+    this->add_edge({v1, v2, lbl});
+  }
+
+  // Removing edges never invalidates the order.
+  void remove_edge(const edge<V, E> &e) {
+    this->_g.remove_edge(e, true);
+    this->_rev.remove_edge({e.v2, e.v1, e.label}, true);
+  }
+
+  const graph<V, E> &get_graph() const {
+    return this->_g;
+  }
+
+  // The vertices in topological order.
+  const std::vector<V> &order() const {
+    return this->_order;
+  }
+
+  // Position of [v] in the order.
+  uint position(const V &v) const {
+    return this->_ord.at(v);
+  }
+
+private:
+  graph<V, E> _g;
+  graph<V, E> _rev; // '_g' with the edges reversed.
+  std::unordered_map<V, uint> _ord; // Position of each vertex.
+  std::vector<V> _order;            // Vertex at each position.
+
+  void _reorder(std::vector<V> &backward, std::vector<V> &forward) {
+    auto by_ord = [this](const V &a, const V &b) {
+      return this->_ord.at(a) < this->_ord.at(b);
+    };
+    std::sort(backward.begin(), backward.end(), by_ord);
+    std::sort(forward.begin(), forward.end(), by_ord);
+
+    std::vector<uint> positions;
+    positions.reserve(backward.size() + forward.size());
+    for (const auto &v : backward) {
+      positions.push_back(this->_ord.at(v));
+    }
+    for (const auto &v : forward) {
+      positions.push_back(this->_ord.at(v));
+    }
+    std::sort(positions.begin(), positions.end());
+
+    uint i = 0;
+    for (const auto *vs : {&backward, &forward}) {
+      for (const auto &v : *vs) {
+        this->_ord[v] = positions[i];
+        this->_order[positions[i]] = v;
+        i++;
+      }
+    }
+  }
+};
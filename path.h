@@ -0,0 +1,210 @@
+// Path results: the vertices of a path in order, with its total
+// distance. Edge labels aren't stored -- most callers only want the
+// distance, or the vertices -- but are looked up in the graph on
+// demand ('edge_at', 'edges'), so building a path is only a walk over
+// the predecessors.
+//
+// 'paths::build' makes one from predecessors and distances (maps, or
+// vectors indexed by integral vertices, see common::predecessor), and
+// 'paths::build_all' makes many from the same predecessors, e.g., to
+// all the destinations of a shortest path tree (see dijkstra::tree),
+// measuring shared prefixes only once.
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+#include "graph.h"
+
+template <typename V, typename E>
+class path_result {
+public:
+  using vertex_type = V;
+  using label_type = E;
+
+  // No path.
+  path_result() {}
+
+  path_result(std::vector<V> vertices, E distance)
+    : _vertices(std::move(vertices)), _distance(distance) {}
+
+  bool found() const {
+    return !this->_vertices.empty();
+  }
+
+  explicit operator bool() const {
+    return this->found();
+  }
+
+  // Total weight of the path (throws if there's none).
+  E distance() const {
+    if (!this->found()) {
+      throw std::logic_error("no path");
+    }
+    return this->_distance;
+  }
+
+  // Vertices from the source to the destination (none if there's no
+  // path).
+  const std::vector<V> &vertices() const {
+    return this->_vertices;
+  }
+
+  // Number of edges.
+  std::size_t size() const {
+    return this->found() ? this->_vertices.size() - 1 : 0;
+  }
+
+  // Edge [i] of the path, labeled by its weight in [g] (the lightest
+  // of any parallel edges).
+  template <common::Graph G>
+  requires std::same_as<common::edge_t<G>, edge<V, E>>
+  edge<V, E> edge_at(const G &g, std::size_t i) const {
+    const V &u = this->_vertices.at(i);
+    const V &v = this->_vertices.at(i + 1);
+    bool any = false;
+    E label{};
+    for (const auto &e : g.out_edges(u)) {
+      if (e.v2 == v && (!any || e.label < label)) {
+        label = e.label;
+        any = true;
+      }
+    }
+    if (!any) {
+      throw std::invalid_argument("edge not in graph");
+    }
+    return {u, v, label};
+  }
+
+  // View of the labeled edges of the path, looked up in [g] (which
+  // must outlive it) as they're visited.
+  template <common::Graph G>
+  requires std::same_as<common::edge_t<G>, edge<V, E>>
+  auto edges(const G &g) const {
+    return std::views::iota(std::size_t{0}, this->size()) |
+      std::views::transform([this, &g](std::size_t i) { return this->edge_at(g, i); });
+  }
+
+  // Edges with default labels (as common::build_path makes them).
+  std::vector<edge<V, E>> unlabeled_edges() const {
+    std::vector<edge<V, E>> es;
+    es.reserve(this->size());
+    for (std::size_t i = 0; i < this->size(); i++) {
+      es.push_back({this->_vertices[i], this->_vertices[i + 1], {}});
+    }
+    return es;
+  }
+
+private:
+  std::vector<V> _vertices;
+  E _distance{};
+};
+
+namespace paths {
+
+  // Distance of [v] in [dist] (a map from vertices, or a vector indexed
+  // by integral vertices).
+  template <typename Dist, typename V>
+  auto _distance(const Dist &dist, const V &v) {
+    if constexpr (requires { dist.find(v) == dist.end(); }) {
+      return dist.at(v);
+    } else {
+      return dist[v];
+    }
+  }
+
+  // Path from [src] to [dest] along predecessors [pred] (see
+  // common::predecessor), whose distance is [dest]'s in [dist].
+  // Returns no path if [src] isn't reached going back from [dest].
+  template <typename V, typename Map, typename Dist>
+  auto build(const Map &pred, const Dist &dist, const V &src, const V &dest) {
+    using E = std::remove_cvref_t<decltype(_distance(dist, dest))>;
+
+    std::size_t n = 0;
+    for (const V *cur = &dest; *cur != src; n++) {
+      cur = common::predecessor(pred, *cur);
+      if (!cur) {
+        return path_result<V, E>();
+      }
+    }
+
+    std::vector<V> vs(n + 1);
+    vs[n] = dest;
+    for (const V *cur = &dest; n > 0; ) {
+      cur = common::predecessor(pred, *cur);
+      vs[--n] = *cur;
+    }
+    return path_result<V, E>(std::move(vs), _distance(dist, dest));
+  }
+
+  // Paths from [src] to each of [dests] along the same predecessors
+  // (see 'build'). Path lengths are memoized, so each vertex is only
+  // measured once however many paths go through it.
+  template <typename V, typename Map, typename Dist>
+  auto build_all(const Map &pred, const Dist &dist, const V &src, std::span<const V> dests) {
+    using E = std::remove_cvref_t<decltype(_distance(dist, src))>;
+    constexpr std::size_t unreachable = std::numeric_limits<std::size_t>::max();
+
+    // Number of edges from [src] to each vertex seen so far.
+    std::unordered_map<V, std::size_t> depth;
+    depth[src] = 0;
+    std::vector<V> stack;
+    auto measure = [&](const V &dest) {
+      stack.clear();
+      V cur = dest;
+      std::size_t d = unreachable;
+      for (;;) {
+        if (auto it = depth.find(cur); it != depth.end()) {
+          d = it->second;
+          break;
+        }
+        stack.push_back(cur);
+        auto p = common::predecessor(pred, cur);
+        if (!p) {
+          break;
+        }
+        cur = *p;
+      }
+      while (!stack.empty()) {
+        if (d != unreachable) {
+          d++;
+        }
+        depth[stack.back()] = d;
+        stack.pop_back();
+      }
+      return d;
+    };
+
+    std::vector<path_result<V, E>> result;
+    result.reserve(dests.size());
+    for (const auto &dest : dests) {
+      std::size_t n = measure(dest);
+      if (n == unreachable) {
+        result.emplace_back();
+        continue;
+      }
+      std::vector<V> vs(n + 1);
+      vs[n] = dest;
+      for (const V *cur = &dest; n > 0; ) {
+        cur = common::predecessor(pred, *cur);
+        vs[--n] = *cur;
+      }
+      result.emplace_back(std::move(vs), _distance(dist, dest));
+    }
+    return result;
+  }
+
+  template <typename V, typename Map, typename Dist>
+  auto build_all(const Map &pred, const Dist &dist, const V &src, const std::vector<V> &dests) {
+    return build_all(pred, dist, src, std::span<const V>(dests));
+  }
+}
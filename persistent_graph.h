@@ -0,0 +1,251 @@
+// Persistent (immutable, versioned) graph. Same interface as 'graph'
+// for reading, but every update returns a new version of the graph
+// and leaves the old one unchanged, so forking a graph for what-if
+// analysis costs O(1) instead of a full copy. Versions share all the
+// structure they have in common:
+//
+// - the vertices map to their out-edges (and in-degrees) in a hash
+//   array mapped trie (see hamt.h), so an update copies O(log32 n)
+//   trie nodes;
+// - the out-edges of each vertex are an immutable vector, shared
+//   between versions until an update touches that vertex, which
+//   copies just its edges (O(out-degree)).
+//
+// Versions can be used from multiple threads: nothing reachable from
+// a version is ever modified.
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "graph.h"
+#include "hamt.h"
+
+template <typename V, typename E>
+class persistent_graph {
+public:
+  using vertex_type = V;
+  using label_type = E;
+  using edge = ::edge<V, E>;
+
+  persistent_graph() {}
+
+  // Persistent copy of [g].
+  explicit persistent_graph(const graph<V, E> &g) {
+    for (const auto &v : g.vertex_view()) {
+      this->_indegree = this->_indegree.set(v, g.in_degree(v));
+      const auto es = g.out_edges(v);
+      this->_adj = this->_adj.set(v, std::make_shared<const edges_type>(es.begin(), es.end()));
+      this->_num_edges += es.size();
+    }
+  }
+
+  // Updates (each returns the new version).
+
+  // Graph with vertex [v] added (throws if it already exists).
+  [[nodiscard]] persistent_graph add_vertex(const V &v) const {
+    if (this->contains(v)) {
+      throw std::invalid_argument("vertex already in graph");
+    }
+    persistent_graph g = *this;
+    g._adj = g._adj.set(v, nullptr);
+    g._indegree = g._indegree.set(v, 0);
+    return g;
+  }
+
+  // Graph with edge [e] added, with the same semantics as
+  // 'graph::add_edge'.
+  [[nodiscard]] persistent_graph add_edge(const edge &e, bool directed=false,
+                                          bool multigraph=false) const {
+    if (!this->contains(e.v1)) {
+      throw std::invalid_argument("v1 not in graph");
+    }
+    if (!this->contains(e.v2)) {
+      throw std::invalid_argument("v2 not in graph");
+    }
+    persistent_graph g = *this;
+    g._add_edge(e, multigraph);
+    if (!directed) {
+      g._add_edge({e.v2, e.v1, e.label}, multigraph);
+    }
+    return g;
+  }
+
+  [[nodiscard]] persistent_graph add_edge(const V &v1, const V &v2, const E &lbl,
+                                          bool directed=false, bool multigraph=false) const {
+    return this->add_edge({v1, v2, lbl}, directed, multigraph);
+  }
+
+  // Graph with edges [es] added, like 'graph::add_edges' (copying the
+  // out-edges of each affected vertex once).
+  [[nodiscard]] persistent_graph add_edges(std::span<const edge> es,
+                                           bool directed=false) const {
+    std::unordered_map<V, std::vector<edge>> added;
+    for (const auto &e : es) {
+      if (!this->contains(e.v1)) {
+        throw std::invalid_argument("v1 not in graph");
+      }
+      if (!this->contains(e.v2)) {
+        throw std::invalid_argument("v2 not in graph");
+      }
+      added[e.v1].push_back(e);
+      if (!directed) {
+        added[e.v2].push_back({e.v2, e.v1, e.label});
+      }
+    }
+
+    persistent_graph g = *this;
+    std::unordered_map<V, uint> indegree;
+    for (auto &[v, new_es] : added) {
+      const auto old = g.out_edges(v);
+      auto merged = std::make_shared<edges_type>(old.begin(), old.end());
+      merged->insert(merged->end(), new_es.begin(), new_es.end());
+      g._adj = g._adj.set(v, std::move(merged));
+      for (const auto &e : new_es) {
+        indegree[e.v2]++;
+      }
+      g._num_edges += new_es.size();
+    }
+    for (const auto &[v, d] : indegree) {
+      g._indegree = g._indegree.set(v, g.in_degree(v) + d);
+    }
+    return g;
+  }
+
+  // Graph with (all copies of) edge [e] removed, like
+  // 'graph::remove_edge'.
+  [[nodiscard]] persistent_graph remove_edge(const edge &e, bool directed=false) const {
+    persistent_graph g = *this;
+    g._remove_edge(e);
+    if (!directed) {
+      g._remove_edge({e.v2, e.v1, e.label});
+    }
+    return g;
+  }
+
+  // Reading (same as 'graph').
+
+  bool contains(const V &v) const {
+    return this->_adj.contains(v);
+  }
+
+  constexpr uint num_vertices() const {
+    return this->_adj.size();
+  }
+
+  constexpr uint64_t num_edges() const {
+    return this->_num_edges;
+  }
+
+  // All vertices (copies, in no particular order).
+  std::vector<V> vertices() const {
+    std::vector<V> vs;
+    vs.reserve(this->num_vertices());
+    this->_adj.for_each([&vs](const V &v, const auto&) {
+      vs.push_back(v);
+    });
+    return vs;
+  }
+
+  std::vector<V> vertex_view() const {
+    return this->vertices();
+  }
+
+  // View of the edges out of [v] (no copies). Stays valid as long as
+  // this version (or any other sharing them) is alive.
+  std::span<const edge> out_edges(const V &v) const {
+    if (const auto *es = this->_adj.find(v)) {
+      return *es ? std::span<const edge>(**es) : std::span<const edge>();
+    }
+    throw std::invalid_argument("vertex not in graph");
+  }
+
+  std::vector<edge> edges(const V &v) const {
+    const auto es = this->out_edges(v);
+    return std::vector<edge>(es.begin(), es.end());
+  }
+
+  std::vector<edge> all_edges() const {
+    std::vector<edge> result;
+    result.reserve(this->_num_edges);
+    this->_adj.for_each([&result](const V&, const auto &es) {
+      if (es) {
+        result.insert(result.end(), es->begin(), es->end());
+      }
+    });
+    return result;
+  }
+
+  uint in_degree(const V &v) const {
+    if (const uint *d = this->_indegree.find(v)) {
+      return *d;
+    }
+    throw std::invalid_argument("v not in graph");
+  }
+
+  uint out_degree(const V &v) const {
+    return this->out_edges(v).size();
+  }
+
+  // Mutable copy of this version.
+  graph<V, E> to_graph() const {
+    graph<V, E> g;
+    g.reserve(this->num_vertices());
+    for (const auto &v : this->vertices()) {
+      g.add_vertex(v);
+    }
+    const auto es = this->all_edges();
+    g.add_edges(es, true);
+    return g;
+  }
+
+private:
+  using edges_type = std::vector<edge>;
+
+  hamt<V, std::shared_ptr<const edges_type>> _adj; // Null if no out-edges.
+  hamt<V, uint> _indegree;
+  uint64_t _num_edges = 0;
+
+  // Add directed edge [e] to this (fresh) version.
+  void _add_edge(const edge &e, bool multigraph) {
+    const auto old = this->out_edges(e.v1);
+    auto es = std::make_shared<edges_type>(old.begin(), old.end());
+    auto x = std::find_if(es->begin(), es->end(), [&e](const edge &x) {
+      return x.v2 == e.v2;
+    });
+    if (!multigraph && x != es->end()) {
+      x->label = e.label;
+    } else {
+      es->push_back(e);
+      this->_indegree = this->_indegree.set(e.v2, this->in_degree(e.v2) + 1);
+      this->_num_edges++;
+    }
+    this->_adj = this->_adj.set(e.v1, std::move(es));
+  }
+
+  // Remove all copies of directed edge [e] from this (fresh) version.
+  void _remove_edge(const edge &e) {
+    if (!this->contains(e.v1)) {
+      return;
+    }
+    const auto old = this->out_edges(e.v1);
+    const uint n = std::count(old.begin(), old.end(), e);
+    if (n == 0) {
+      return;
+    }
+    auto es = std::make_shared<edges_type>();
+    es->reserve(old.size() - n);
+    std::copy_if(old.begin(), old.end(), std::back_inserter(*es), [&e](const edge &x) {
+      return !(x == e);
+    });
+    this->_adj = this->_adj.set(e.v1, es->empty() ? nullptr : std::move(es));
+    this->_indegree = this->_indegree.set(e.v2, this->in_degree(e.v2) - n);
+    this->_num_edges -= n;
+  }
+};
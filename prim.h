@@ -4,24 +4,43 @@
 
 #pragma once
 
+#include <memory_resource>
+#include <optional>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "binary_heap.h"
 #include "common.h"
 #include "graph.h"
+#include "instrument.h"
+#include "scan_heap.h"
 
 namespace prim {
 
-  template <typename V, common::Numeric E>
-  std::vector<edge<V, E>> mst(const graph<V, E> &g) {
+  // All scratch state is allocated from memory resource [mr] (see
+  // workspace.h), and operation counts are recorded by instrumentation
+  // policy [stats] (see instrument.h).
+  template <common::WeightedGraph G,
+            instrument::Policy S = instrument::none>
+  std::vector<common::edge_t<G>> mst(const G &g,
+                                     std::pmr::memory_resource *mr =
+                                     std::pmr::get_default_resource(),
+                                     S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    // Count scratch allocations (when instrumented).
+    instrument::resource<S> counted(mr, stats);
+    mr = counted.get();
+
     // Mapping of each vertex to the edge providing its cheapest
     // connection to the MST so far (if one exists).
-    std::unordered_map<V, edge<V, E>> edges;
+    std::pmr::unordered_map<V, edge<V, E>> edges(mr);
 
     // Mapping of each vertex to the cost of its cheapest connection
     // to MST so far.
-    std::function<E(const V&)> cost = [&edges = std::as_const(edges)](const V &v) {
+    auto cost = [&edges = std::as_const(edges)](const V &v) {
       if (edges.contains(v)) {
         return edges.at(v).label;
       } else {
@@ -29,16 +48,12 @@ namespace prim {
       }
     };
 
-    // Initialize all edges to 'none'.
-    for (const auto &v : g.vertices()) {
-      edges[v] = {};
-    }
-
     // The MST to be built and returned.
     std::vector<edge<V, E>> mst;
 
     // Initialize the open set to contain all the vertices.
-    std::vector<V> open = g.vertices();
+    auto vs = g.vertex_view();
+    std::pmr::vector<V> open(vs.begin(), vs.end(), mr);
 
     // Main loop.
     while (!open.empty()) {
@@ -47,6 +62,8 @@ namespace prim {
       uint min_i = common::min_index(open, cost);
       V u = open[min_i];
       open.erase(open.begin() + min_i);
+      stats.extract();
+      stats.settle();
 
       // If the vertex is connected to the MST built so far, add the
       // connecting edge. If this isn't true, then all the remaining
@@ -59,10 +76,12 @@ namespace prim {
       // For all of the vertex's neighbors still in the open set,
       // update their cheapest edges if necessary (in case there's now
       // a cheaper edge through the current vertex).
-      for (const auto &e : g.edges(u)) {
+      for (const auto &e : g.out_edges(u)) {
+        stats.relax();
         if (common::contains(open, e.v2)) {
           if (e.label < cost(e.v2)) {
-            edges[e.v2] = e;
+            edges.insert_or_assign(e.v2, e);
+            stats.decrease_key();
           }
         }
       }
@@ -73,15 +92,27 @@ namespace prim {
 
   // Alternate version that uses a binary min-heap for the open
   // set. Appears to perform about the same on the PE#107 example.
-  template <typename V, common::Numeric E>
-  std::vector<edge<V, E>> mst2(const graph<V, E> &g) {
+  template <common::WeightedGraph G,
+            instrument::Policy S = instrument::none>
+  std::vector<common::edge_t<G>> mst2(const G &g,
+                                      std::pmr::memory_resource *mr =
+                                      std::pmr::get_default_resource(),
+                                      S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    // Count scratch allocations (when instrumented).
+    instrument::resource<S> counted(mr, stats);
+    mr = counted.get();
+
     // Mapping of each vertex to the edge providing its cheapest
     // connection to the MST so far (if one exists).
-    std::unordered_map<V, std::optional<edge<V, E>>> edges;
+    std::pmr::unordered_map<V, std::optional<edge<V, E>>> edges(mr);
+    edges.reserve(g.num_vertices());
 
     // Mapping of each vertex to the cost of its cheapest connection
     // to MST so far.
-    std::function<E(const V&)> cost = [&edges = std::as_const(edges)](const V &v) {
+    auto cost = [&edges = std::as_const(edges)](const V &v) {
       if (edges.at(v).has_value()) {
         return edges.at(v).value().label;
       } else {
@@ -90,7 +121,7 @@ namespace prim {
     };
 
     // Initialize all edges to 'none'.
-    for (const auto &v : g.vertices()) {
+    for (const auto &v : g.vertex_view()) {
       edges[v] = {};
     }
 
@@ -99,9 +130,10 @@ namespace prim {
 
     // Initialize the open set to contain all the vertices.
     // std::vector<V> open = g.vertices();
-    binary_heap<V, E> open;
-    for (const auto &v : g.vertices()) {
+    binary_heap<V, E> open(mr);
+    for (const auto &v : g.vertex_view()) {
       open.insert(v, cost(v));
+      stats.heap_insert();
     }
 
     // Main loop.
@@ -112,6 +144,90 @@ namespace prim {
       // V u = open[min_i];
       // open.erase(open.begin() + min_i);
       V u = open.extract().first;
+      stats.extract();
+      stats.settle();
+
+      // If the vertex is connected to the MST built so far, add the
+      // connecting edge. If this isn't true, then all the remaining
+      // vertices must be disconnected from the MST built so far, so
+      // we're starting an MST of a new connected component of g.
+      if (edges[u].has_value()) {
+        mst.push_back(edges[u].value());
+      }
+
+      // For all of the vertex's neighbors still in the open set,
+      // update their cheapest edges if necessary (in case there's now
+      // a cheaper edge through the current vertex).
+      for (const auto &e : g.out_edges(u)) {
+        stats.relax();
+        if (open.contains(e.v2)) {
+          if (e.label < cost(e.v2)) {
+            edges[e.v2] = e;
+            open.decrease_key(e.v2, cost(e.v2));
+            stats.decrease_key();
+          }
+        }
+      }
+    }
+
+    return mst;
+  }
+
+  // Alternate version of 'mst' that keeps the costs of the open set
+  // in a contiguous array (see scan_heap.h), so the cheapest vertex is
+  // found with a vectorized argmin (see simd.h) and membership checks
+  // are hash lookups instead of linear scans.
+  template <common::WeightedGraph G,
+            instrument::Policy S = instrument::none>
+  std::vector<common::edge_t<G>> mst3(const G &g,
+                                      std::pmr::memory_resource *mr =
+                                      std::pmr::get_default_resource(),
+                                      S &stats = instrument::off) {
+    using V = common::vertex_t<G>;
+    using E = common::label_t<G>;
+
+    // Count scratch allocations (when instrumented).
+    instrument::resource<S> counted(mr, stats);
+    mr = counted.get();
+
+    // Mapping of each vertex to the edge providing its cheapest
+    // connection to the MST so far (if one exists).
+    std::pmr::unordered_map<V, std::optional<edge<V, E>>> edges(mr);
+    edges.reserve(g.num_vertices());
+
+    // Mapping of each vertex to the cost of its cheapest connection
+    // to MST so far.
+    auto cost = [&edges = std::as_const(edges)](const V &v) {
+      if (edges.at(v).has_value()) {
+        return edges.at(v).value().label;
+      } else {
+        return std::numeric_limits<E>::max();
+      }
+    };
+
+    // Initialize all edges to 'none'.
+    for (const auto &v : g.vertex_view()) {
+      edges[v] = {};
+    }
+
+    // The MST to be built and returned.
+    std::vector<edge<V, E>> mst;
+
+    // Initialize the open set to contain all the vertices.
+    scan_heap<V, E> open(mr);
+    open.reserve(g.num_vertices());
+    for (const auto &v : g.vertex_view()) {
+      open.insert(v, cost(v));
+      stats.heap_insert();
+    }
+
+    // Main loop.
+    while (open.size()) {
+      // Remove from the open set the vertex with the lowest cost to
+      // add to the MST.
+      V u = open.extract().first;
+      stats.extract();
+      stats.settle();
 
       // If the vertex is connected to the MST built so far, add the
       // connecting edge. If this isn't true, then all the remaining
@@ -124,11 +240,13 @@ namespace prim {
       // For all of the vertex's neighbors still in the open set,
       // update their cheapest edges if necessary (in case there's now
       // a cheaper edge through the current vertex).
-      for (const auto &e : g.edges(u)) {
+      for (const auto &e : g.out_edges(u)) {
+        stats.relax();
         if (open.contains(e.v2)) {
           if (e.label < cost(e.v2)) {
             edges[e.v2] = e;
             open.decrease_key(e.v2, cost(e.v2));
+            stats.decrease_key();
           }
         }
       }
@@ -0,0 +1,418 @@
+// Vertex reorderings that improve memory locality. The order in which
+// 'graph' stores its vertices is effectively random (it comes from
+// hashing), so neighboring vertices end up far apart in memory. These
+// functions compute a permutation of the vertices that tends to place
+// neighbors close together, and relabel a graph by it (vertex i of the
+// result is the i-th vertex of the permutation), which is most useful
+// together with 'compact_graph' (see compact_graph.h) since it stores
+// vertices and their edges in index order.
+//
+// The orderings are:
+//
+// - reverse Cuthill-McKee: breadth-first from a pseudo-peripheral
+//   vertex of each component, visiting neighbors by increasing degree,
+//   then reversed. Minimizes the bandwidth (max distance between the
+//   indices of adjacent vertices) in practice. Edges are treated as
+//   undirected;
+// - degree: by decreasing out-degree, which packs the hubs of skewed
+//   graphs together;
+// - breadth-first: the order in which a BFS (restarted at each
+//   unvisited vertex) discovers the vertices;
+// - Hilbert: by position along a Hilbert curve, for graphs whose
+//   vertices have 2D coordinates (e.g., grids, like the matrix of
+//   PE#83).
+//
+// Ties are broken by vertex order (when V is totally ordered), so the
+// orderings are deterministic.
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+#include "compact_graph.h"
+#include "graph.h"
+
+namespace reorder {
+
+  // Permutation of the vertices of a graph, with the mapping tables in
+  // both directions.
+  template <typename V>
+  class permutation {
+  public:
+    permutation() {}
+
+    // The vertex at each new index [order] (throws if it contains
+    // duplicates).
+    explicit permutation(std::vector<V> order) : _order(std::move(order)) {
+      this->_position.reserve(this->_order.size());
+      for (uint i = 0; i < this->_order.size(); i++) {
+        if (!this->_position.try_emplace(this->_order[i], i).second) {
+          throw std::invalid_argument("vertex appears twice in permutation");
+        }
+      }
+    }
+
+    constexpr uint size() const {
+      return this->_order.size();
+    }
+
+    // Vertex at new index [i].
+    const V &label(uint i) const {
+      return this->_order[i];
+    }
+
+    // New index of vertex [v].
+    uint index(const V &v) const {
+      if (auto it = this->_position.find(v); it != this->_position.end()) {
+        return it->second;
+      }
+      throw std::invalid_argument("vertex not in permutation");
+    }
+
+    const std::vector<V> &order() const {
+      return this->_order;
+    }
+
+    // Edges [es] of a relabeled graph (e.g., a path found in it)
+    // translated back to the original vertices.
+    template <typename Edge>
+    auto restore(const std::vector<Edge> &es) const {
+      std::vector<edge<V, decltype(Edge::label)>> result;
+      result.reserve(es.size());
+      for (const auto &e : es) {
+        result.push_back({this->label(e.v1), this->label(e.v2), e.label});
+      }
+      return result;
+    }
+
+  private:
+    std::vector<V> _order;
+    std::unordered_map<V, uint> _position;
+  };
+
+  // Adjacency of [g] in terms of vertex indices (in vertex order), so
+  // the orderings can work on plain arrays.
+  template <common::Graph G>
+  struct _indexed {
+    std::vector<common::vertex_t<G>> vs;
+    std::vector<uint> offsets; // Edges of vertex i are adj[offsets[i]:offsets[i+1]].
+    std::vector<uint> adj;
+
+    _indexed(const G &g, bool undirected) {
+      using V = common::vertex_t<G>;
+      auto view = g.vertex_view();
+      this->vs.assign(view.begin(), view.end());
+      if constexpr (std::totally_ordered<V>) {
+        std::sort(this->vs.begin(), this->vs.end());
+      }
+      std::unordered_map<V, uint> ixs;
+      ixs.reserve(this->vs.size());
+      for (uint i = 0; i < this->vs.size(); i++) {
+        ixs[this->vs[i]] = i;
+      }
+
+      std::vector<std::pair<uint, uint>> es;
+      for (uint i = 0; i < this->vs.size(); i++) {
+        for (const auto &e : g.out_edges(this->vs[i])) {
+          const uint j = ixs.at(e.v2);
+          es.push_back({i, j});
+          if (undirected) {
+            es.push_back({j, i});
+          }
+        }
+      }
+      if (undirected) {
+        // Drop the duplicates of edges that were already symmetric.
+        std::sort(es.begin(), es.end());
+        es.erase(std::unique(es.begin(), es.end()), es.end());
+      }
+
+      this->offsets.assign(this->vs.size() + 1, 0);
+      for (const auto &[i, j] : es) {
+        this->offsets[i + 1]++;
+      }
+      for (uint i = 0; i < this->vs.size(); i++) {
+        this->offsets[i + 1] += this->offsets[i];
+      }
+      this->adj.resize(es.size());
+      std::vector<uint> next(this->offsets.begin(), this->offsets.end() - 1);
+      for (const auto &[i, j] : es) {
+        this->adj[next[i]++] = j;
+      }
+    }
+
+    uint size() const {
+      return this->vs.size();
+    }
+
+    uint degree(uint i) const {
+      return this->offsets[i + 1] - this->offsets[i];
+    }
+
+    std::span<const uint> neighbors(uint i) const {
+      return {this->adj.data() + this->offsets[i], this->degree(i)};
+    }
+
+    permutation<common::vertex_t<G>> to_permutation(const std::vector<uint> &order) const {
+      std::vector<common::vertex_t<G>> result;
+      result.reserve(order.size());
+      for (const uint i : order) {
+        result.push_back(this->vs[i]);
+      }
+      return permutation<common::vertex_t<G>>(std::move(result));
+    }
+  };
+
+  // Vertices of [g] by decreasing out-degree.
+  template <common::Graph G>
+  permutation<common::vertex_t<G>> degree(const G &g) {
+    const _indexed<G> a(g, false);
+    std::vector<uint> order(a.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&a](uint i, uint j) {
+      return a.degree(i) > a.degree(j);
+    });
+    return a.to_permutation(order);
+  }
+
+  // Vertices of [g] in breadth-first order, starting from [src] (and
+  // then from the first unvisited vertex, until all are visited).
+  template <common::Graph G>
+  permutation<common::vertex_t<G>> bfs(const G &g, const common::vertex_t<G> &src) {
+    const _indexed<G> a(g, false);
+    if (!g.contains(src)) {
+      throw std::invalid_argument("source doesn't exist");
+    }
+    std::vector<uint> order;
+    order.reserve(a.size());
+    std::vector<bool> visited(a.size(), false);
+
+    auto search = [&](uint s) {
+      uint head = order.size();
+      order.push_back(s);
+      visited[s] = true;
+      while (head < order.size()) {
+        for (const uint j : a.neighbors(order[head++])) {
+          if (!visited[j]) {
+            visited[j] = true;
+            order.push_back(j);
+          }
+        }
+      }
+    };
+
+    search(std::ranges::find(a.vs, src) - a.vs.begin());
+    for (uint i = 0; i < a.size(); i++) {
+      if (!visited[i]) {
+        search(i);
+      }
+    }
+    return a.to_permutation(order);
+  }
+
+  template <common::Graph G>
+  permutation<common::vertex_t<G>> bfs(const G &g) {
+    auto vs = g.vertex_view();
+    if (vs.begin() == vs.end()) {
+      return {};
+    }
+    if constexpr (std::totally_ordered<common::vertex_t<G>>) {
+      return bfs(g, std::ranges::min(vs));
+    } else {
+      return bfs(g, *vs.begin());
+    }
+  }
+
+  // Vertices of [g] in reverse Cuthill-McKee order.
+  template <common::Graph G>
+  permutation<common::vertex_t<G>> rcm(const G &g) {
+    const _indexed<G> a(g, true);
+    const uint n = a.size();
+    std::vector<uint> order;
+    order.reserve(n);
+    std::vector<bool> visited(n, false);
+
+    // Breadth-first levels from [s] within its (unvisited) component,
+    // as the vertices of the last level and the number of levels.
+    std::vector<uint> level(n, 0), queue;
+    auto last_level = [&](uint s) {
+      queue = {s};
+      level[s] = 1;
+      for (uint head = 0; head < queue.size(); head++) {
+        const uint i = queue[head];
+        for (const uint j : a.neighbors(i)) {
+          if (!level[j]) {
+            level[j] = level[i] + 1;
+            queue.push_back(j);
+          }
+        }
+      }
+      const uint depth = level[queue.back()];
+      std::vector<uint> last;
+      for (const uint i : queue) {
+        if (level[i] == depth) {
+          last.push_back(i);
+        }
+        level[i] = 0;
+      }
+      return std::make_pair(std::move(last), depth);
+    };
+
+    auto min_degree = [&a](const std::vector<uint> &is) {
+      return *std::ranges::min_element(is, [&a](uint i, uint j) {
+        return a.degree(i) < a.degree(j);
+      });
+    };
+
+    // Start each component from a minimum degree vertex.
+    std::vector<uint> starts(n);
+    std::iota(starts.begin(), starts.end(), 0u);
+    std::stable_sort(starts.begin(), starts.end(), [&a](uint i, uint j) {
+      return a.degree(i) < a.degree(j);
+    });
+
+    std::vector<uint> next;
+    for (const uint s : starts) {
+      if (visited[s]) {
+        continue;
+      }
+
+      // Pseudo-peripheral vertex (George and Liu): move to a minimum
+      // degree vertex of the last level while that increases the
+      // number of levels.
+      uint r = s;
+      auto [last, depth] = last_level(r);
+      for (;;) {
+        const uint x = min_degree(last);
+        auto [x_last, x_depth] = last_level(x);
+        if (x_depth <= depth) {
+          break;
+        }
+        r = x;
+        last = std::move(x_last);
+        depth = x_depth;
+      }
+
+      // Cuthill-McKee from there.
+      uint head = order.size();
+      order.push_back(r);
+      visited[r] = true;
+      while (head < order.size()) {
+        next.clear();
+        for (const uint j : a.neighbors(order[head++])) {
+          if (!visited[j]) {
+            visited[j] = true;
+            next.push_back(j);
+          }
+        }
+        std::stable_sort(next.begin(), next.end(), [&a](uint i, uint j) {
+          return a.degree(i) < a.degree(j);
+        });
+        order.insert(order.end(), next.begin(), next.end());
+      }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return a.to_permutation(order);
+  }
+
+  // Distance of point ([x], [y]) along the Hilbert curve filling the
+  // [n] by [n] grid ([n] a power of 2).
+  constexpr uint64_t hilbert_index(uint64_t n, uint64_t x, uint64_t y) {
+    uint64_t d = 0;
+    for (uint64_t s = n / 2; s > 0; s /= 2) {
+      const uint64_t rx = (x & s) > 0;
+      const uint64_t ry = (y & s) > 0;
+      d += s * s * ((3 * rx) ^ ry);
+      // Rotate the quadrant.
+      if (ry == 0) {
+        if (rx == 1) {
+          x = n - 1 - x;
+          y = n - 1 - y;
+        }
+        std::swap(x, y);
+      }
+    }
+    return d;
+  }
+
+  // Vertices of [g] in Hilbert curve order of their 2D coordinates,
+  // given by [coords] (a function from vertices to pairs of unsigned
+  // integers, e.g., the row and column in a grid).
+  template <common::Graph G, typename F>
+  requires std::invocable<F, const common::vertex_t<G>&>
+  permutation<common::vertex_t<G>> hilbert(const G &g, F coords) {
+    const _indexed<G> a(g, false);
+    std::vector<std::pair<uint64_t, uint64_t>> xy;
+    xy.reserve(a.size());
+    uint64_t max = 0;
+    for (const auto &v : a.vs) {
+      const auto [x, y] = coords(v);
+      xy.push_back({x, y});
+      max = std::max<uint64_t>({max, x, y});
+    }
+    uint64_t n = 1;
+    while (n <= max) {
+      n *= 2;
+    }
+
+    std::vector<uint64_t> d(a.size());
+    for (uint i = 0; i < a.size(); i++) {
+      d[i] = hilbert_index(n, xy[i].first, xy[i].second);
+    }
+    std::vector<uint> order(a.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&d](uint i, uint j) {
+      return d[i] < d[j];
+    });
+    return a.to_permutation(order);
+  }
+
+  // Copy of [g] with each vertex replaced by its index in [p] (of
+  // integer type I).
+  template <std::integral I = uint, common::Graph G>
+  graph<I, common::label_t<G>> relabel(const G &g,
+                                       const permutation<common::vertex_t<G>> &p) {
+    using E = common::label_t<G>;
+    graph<I, E> result;
+    result.reserve(p.size());
+    std::vector<edge<I, E>> es;
+    for (uint i = 0; i < p.size(); i++) {
+      result.add_vertex(static_cast<I>(i));
+      for (const auto &e : g.out_edges(p.label(i))) {
+        es.push_back({static_cast<I>(i), static_cast<I>(p.index(e.v2)), e.label});
+      }
+    }
+    result.add_edges(es, true);
+    return result;
+  }
+
+  // Same, as a compact graph (whose vertices and edges are then laid
+  // out in the order of [p]).
+  template <std::integral I = uint, common::Graph G,
+            std::unsigned_integral Index = uint32_t,
+            typename Weight = common::label_t<G>>
+  compact_graph<I, common::label_t<G>, Index, Weight>
+  relabel_compact(const G &g, const permutation<common::vertex_t<G>> &p) {
+    using E = common::label_t<G>;
+    std::vector<I> vs(p.size());
+    std::iota(vs.begin(), vs.end(), I{0});
+    std::vector<edge<I, E>> es;
+    for (uint i = 0; i < p.size(); i++) {
+      for (const auto &e : g.out_edges(p.label(i))) {
+        es.push_back({static_cast<I>(i), static_cast<I>(p.index(e.v2)), e.label});
+      }
+    }
+    return compact_graph<I, E, Index, Weight>(vs, es);
+  }
+}
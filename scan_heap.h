@@ -0,0 +1,82 @@
+// Unsorted-array priority queue with the same interface as
+// binary_heap. The values (priorities) are kept in their own
+// contiguous array so that 'extract' can find the minimum with a
+// single vectorized scan (see simd.h), and removal swaps the last
+// element into the hole. Insert and decrease-key are O(1), extract is
+// O(n) -- but a very cache- and SIMD-friendly O(n), which beats the
+// pointer chasing of a heap while the queue is small (up to a few
+// thousand elements).
+
+#pragma once
+
+#include <memory_resource>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "simd.h"
+
+template <typename K, std::totally_ordered V>
+class scan_heap {
+public:
+
+  scan_heap() : scan_heap(std::pmr::get_default_resource()) {}
+
+  explicit scan_heap(std::pmr::memory_resource *mr)
+    : _keys(mr), _values(mr), _ixs(mr) {}
+
+  // Insert a key/value pair into the heap.
+  void insert(const K &k, const V &v) {
+    if (this->_ixs.try_emplace(k, this->_keys.size()).second) {
+      this->_keys.push_back(k);
+      this->_values.push_back(v);
+    } else {
+      throw std::invalid_argument("key already exists");
+    }
+  }
+
+  // Extract the minimum element from the heap.
+  std::pair<K, V> extract() {
+    if (this->_keys.empty()) {
+      throw std::invalid_argument("heap is empty");
+    }
+    uint i = simd::argmin(this->_values);
+    std::pair<K, V> min = {this->_keys[i], this->_values[i]};
+    this->_ixs.erase(min.first);
+    if (i != this->_keys.size() - 1) {
+      this->_keys[i] = this->_keys.back();
+      this->_values[i] = this->_values.back();
+      this->_ixs[this->_keys[i]] = i;
+    }
+    this->_keys.pop_back();
+    this->_values.pop_back();
+    return min;
+  }
+
+  // Associate to key [k] a new value [v] (must be less than or equal
+  // to the previous value associated with [k]).
+  void decrease_key(const K &k, const V &v) {
+    this->_values[this->_ixs.at(k)] = v;
+  }
+
+  constexpr uint size() const {
+    return this->_keys.size();
+  }
+
+  constexpr bool contains(const K &k) {
+    return this->_ixs.contains(k);
+  }
+
+  // Reserve space for [n] elements.
+  void reserve(uint n) {
+    this->_keys.reserve(n);
+    this->_values.reserve(n);
+    this->_ixs.reserve(n);
+  }
+
+private:
+  std::pmr::vector<K> _keys;
+  std::pmr::vector<V> _values;
+  std::pmr::unordered_map<K, uint> _ixs;
+};
@@ -0,0 +1,297 @@
+// Vectorized argmin over a contiguous array of keys, used by the
+// linear-scan priority queue in scan_heap.h. There are AVX2 and
+// AVX-512 kernels for 32 and 64-bit integer and floating point keys,
+// and the best one the CPU supports is chosen at run time (so the
+// code doesn't need to be compiled with -mavx2 etc.). Other key
+// types, other architectures and other compilers fall back to a
+// plain scalar loop.
+//
+// All versions return the index of the *first* minimum element, so
+// they agree with each other exactly. NaN keys aren't supported.
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+  (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SIMD_X86 0
+#endif
+
+namespace simd {
+
+  enum class isa { scalar, avx2, avx512 };
+
+  // Best instruction set supported by the CPU (detected once).
+  inline isa detect() {
+#if SIMD_X86
+    static const isa best = __builtin_cpu_supports("avx512f") ? isa::avx512
+      : __builtin_cpu_supports("avx2") ? isa::avx2
+      : isa::scalar;
+    return best;
+#else
+    return isa::scalar;
+#endif
+  }
+
+  // Scalar argmin of [k][0..n) (0 when n is 0).
+  template <typename T>
+  std::size_t argmin_scalar(const T *k, std::size_t n) {
+    std::size_t min_i = 0;
+    for (std::size_t i = 1; i < n; i++) {
+      if (k[i] < k[min_i]) {
+        min_i = i;
+      }
+    }
+    return min_i;
+  }
+
+#if SIMD_X86
+  // The kernels keep the minimum seen so far in each lane together
+  // with its index. At the end we pick the smallest of the lanes
+  // (breaking ties by index, so we get the first occurrence) and
+  // finish the leftover elements past the last full vector.
+  template <typename T, typename I, std::size_t W>
+  std::size_t _reduce(const T (&vals)[W], const I (&ixs)[W],
+                      const T *k, std::size_t n, std::size_t i) {
+    std::size_t min_i = ixs[0];
+    T min = vals[0];
+    for (std::size_t l = 1; l < W; l++) {
+      if (vals[l] < min || (vals[l] == min && ixs[l] < min_i)) {
+        min_i = ixs[l];
+        min = vals[l];
+      }
+    }
+    for (; i < n; i++) {
+      if (k[i] < min) {
+        min_i = i;
+        min = k[i];
+      }
+    }
+    return min_i;
+  }
+
+  __attribute__((target("avx2")))
+  inline std::size_t _argmin_avx2(const float *k, std::size_t n) {
+    __m256 min = _mm256_loadu_ps(k);
+    __m256i ix = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i min_ix = ix;
+    const __m256i step = _mm256_set1_epi32(8);
+    std::size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+      ix = _mm256_add_epi32(ix, step);
+      __m256 x = _mm256_loadu_ps(k + i);
+      __m256 lt = _mm256_cmp_ps(x, min, _CMP_LT_OQ);
+      min = _mm256_blendv_ps(min, x, lt);
+      min_ix = _mm256_blendv_epi8(min_ix, ix, _mm256_castps_si256(lt));
+    }
+    float vals[8];
+    uint32_t ixs[8];
+    _mm256_storeu_ps(vals, min);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(ixs), min_ix);
+    return _reduce(vals, ixs, k, n, i);
+  }
+
+  __attribute__((target("avx2")))
+  inline std::size_t _argmin_avx2(const int32_t *k, std::size_t n) {
+    __m256i min = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(k));
+    __m256i ix = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i min_ix = ix;
+    const __m256i step = _mm256_set1_epi32(8);
+    std::size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+      ix = _mm256_add_epi32(ix, step);
+      __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(k + i));
+      __m256i lt = _mm256_cmpgt_epi32(min, x);
+      min = _mm256_min_epi32(min, x);
+      min_ix = _mm256_blendv_epi8(min_ix, ix, lt);
+    }
+    int32_t vals[8];
+    uint32_t ixs[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(vals), min);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(ixs), min_ix);
+    return _reduce(vals, ixs, k, n, i);
+  }
+
+  __attribute__((target("avx2")))
+  inline std::size_t _argmin_avx2(const double *k, std::size_t n) {
+    __m256d min = _mm256_loadu_pd(k);
+    __m256i ix = _mm256_setr_epi64x(0, 1, 2, 3);
+    __m256i min_ix = ix;
+    const __m256i step = _mm256_set1_epi64x(4);
+    std::size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+      ix = _mm256_add_epi64(ix, step);
+      __m256d x = _mm256_loadu_pd(k + i);
+      __m256d lt = _mm256_cmp_pd(x, min, _CMP_LT_OQ);
+      min = _mm256_blendv_pd(min, x, lt);
+      min_ix = _mm256_blendv_epi8(min_ix, ix, _mm256_castpd_si256(lt));
+    }
+    double vals[4];
+    uint64_t ixs[4];
+    _mm256_storeu_pd(vals, min);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(ixs), min_ix);
+    return _reduce(vals, ixs, k, n, i);
+  }
+
+  __attribute__((target("avx2")))
+  inline std::size_t _argmin_avx2(const int64_t *k, std::size_t n) {
+    __m256i min = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(k));
+    __m256i ix = _mm256_setr_epi64x(0, 1, 2, 3);
+    __m256i min_ix = ix;
+    const __m256i step = _mm256_set1_epi64x(4);
+    std::size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+      ix = _mm256_add_epi64(ix, step);
+      __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(k + i));
+      __m256i lt = _mm256_cmpgt_epi64(min, x);
+      min = _mm256_blendv_epi8(min, x, lt);
+      min_ix = _mm256_blendv_epi8(min_ix, ix, lt);
+    }
+    int64_t vals[4];
+    uint64_t ixs[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(vals), min);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(ixs), min_ix);
+    return _reduce(vals, ixs, k, n, i);
+  }
+
+  __attribute__((target("avx512f")))
+  inline std::size_t _argmin_avx512(const float *k, std::size_t n) {
+    __m512 min = _mm512_loadu_ps(k);
+    __m512i ix = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                                   8, 9, 10, 11, 12, 13, 14, 15);
+    __m512i min_ix = ix;
+    const __m512i step = _mm512_set1_epi32(16);
+    std::size_t i = 16;
+    for (; i + 16 <= n; i += 16) {
+      ix = _mm512_add_epi32(ix, step);
+      __m512 x = _mm512_loadu_ps(k + i);
+      __mmask16 lt = _mm512_cmp_ps_mask(x, min, _CMP_LT_OQ);
+      min = _mm512_mask_mov_ps(min, lt, x);
+      min_ix = _mm512_mask_mov_epi32(min_ix, lt, ix);
+    }
+    float vals[16];
+    uint32_t ixs[16];
+    _mm512_storeu_ps(vals, min);
+    _mm512_storeu_si512(ixs, min_ix);
+    return _reduce(vals, ixs, k, n, i);
+  }
+
+  __attribute__((target("avx512f")))
+  inline std::size_t _argmin_avx512(const int32_t *k, std::size_t n) {
+    __m512i min = _mm512_loadu_si512(k);
+    __m512i ix = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                                   8, 9, 10, 11, 12, 13, 14, 15);
+    __m512i min_ix = ix;
+    const __m512i step = _mm512_set1_epi32(16);
+    std::size_t i = 16;
+    for (; i + 16 <= n; i += 16) {
+      ix = _mm512_add_epi32(ix, step);
+      __m512i x = _mm512_loadu_si512(k + i);
+      __mmask16 lt = _mm512_cmplt_epi32_mask(x, min);
+      min = _mm512_mask_mov_epi32(min, lt, x);
+      min_ix = _mm512_mask_mov_epi32(min_ix, lt, ix);
+    }
+    int32_t vals[16];
+    uint32_t ixs[16];
+    _mm512_storeu_si512(vals, min);
+    _mm512_storeu_si512(ixs, min_ix);
+    return _reduce(vals, ixs, k, n, i);
+  }
+
+  __attribute__((target("avx512f")))
+  inline std::size_t _argmin_avx512(const double *k, std::size_t n) {
+    __m512d min = _mm512_loadu_pd(k);
+    __m512i ix = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+    __m512i min_ix = ix;
+    const __m512i step = _mm512_set1_epi64(8);
+    std::size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+      ix = _mm512_add_epi64(ix, step);
+      __m512d x = _mm512_loadu_pd(k + i);
+      __mmask8 lt = _mm512_cmp_pd_mask(x, min, _CMP_LT_OQ);
+      min = _mm512_mask_mov_pd(min, lt, x);
+      min_ix = _mm512_mask_mov_epi64(min_ix, lt, ix);
+    }
+    double vals[8];
+    uint64_t ixs[8];
+    _mm512_storeu_pd(vals, min);
+    _mm512_storeu_si512(ixs, min_ix);
+    return _reduce(vals, ixs, k, n, i);
+  }
+
+  __attribute__((target("avx512f")))
+  inline std::size_t _argmin_avx512(const int64_t *k, std::size_t n) {
+    __m512i min = _mm512_loadu_si512(k);
+    __m512i ix = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+    __m512i min_ix = ix;
+    const __m512i step = _mm512_set1_epi64(8);
+    std::size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+      ix = _mm512_add_epi64(ix, step);
+      __m512i x = _mm512_loadu_si512(k + i);
+      __mmask8 lt = _mm512_cmplt_epi64_mask(x, min);
+      min = _mm512_mask_mov_epi64(min, lt, x);
+      min_ix = _mm512_mask_mov_epi64(min_ix, lt, ix);
+    }
+    int64_t vals[8];
+    uint64_t ixs[8];
+    _mm512_storeu_si512(vals, min);
+    _mm512_storeu_si512(ixs, min_ix);
+    return _reduce(vals, ixs, k, n, i);
+  }
+
+  // Key types with a vectorized kernel. 'long' and 'long long' are
+  // both accepted as long as they're 64 bits wide.
+  template <typename T>
+  concept Vectorizable = std::same_as<T, float> || std::same_as<T, double> ||
+    (std::is_integral_v<T> && std::is_signed_v<T> &&
+     (sizeof(T) == 4 || sizeof(T) == 8));
+
+  template <Vectorizable T>
+  std::size_t _dispatch(const T *k, std::size_t n, isa s) {
+    using U = std::conditional_t<std::is_floating_point_v<T>, T,
+                                 std::conditional_t<sizeof(T) == 4,
+                                                    int32_t, int64_t>>;
+    const U *u = reinterpret_cast<const U*>(k);
+    // Vector lanes hold 32-bit indices for 32-bit keys.
+    if (sizeof(T) == 4 && n > std::numeric_limits<uint32_t>::max()) {
+      return argmin_scalar(k, n);
+    }
+    if (s == isa::avx512 && n >= 64 / sizeof(T)) {
+      return _argmin_avx512(u, n);
+    }
+    if (s != isa::scalar && n >= 32 / sizeof(T)) {
+      return _argmin_avx2(u, n);
+    }
+    return argmin_scalar(k, n);
+  }
+#endif
+
+  // Index of the first minimum of [k][0..n) (0 when n is 0), using
+  // instruction set [s] or the best available one by default.
+  template <typename T>
+  std::size_t argmin(const T *k, std::size_t n, isa s = detect()) {
+#if SIMD_X86
+    if constexpr (Vectorizable<T>) {
+      return _dispatch(k, n, s);
+    }
+#endif
+    return argmin_scalar(k, n);
+  }
+
+  template <typename T, typename A>
+  std::size_t argmin(const std::vector<T, A> &v, isa s = detect()) {
+    return argmin(v.data(), v.size(), s);
+  }
+}
+
+#undef SIMD_X86
@@ -1,9 +1,18 @@
 // In-place sorting algorithms on vectors. Generic in the type of
-// elements (subject to the constraint of being a total order).
+// elements (subject to the constraint of being a total order). The
+// merge and radix sorts also come in versions that sort by a key
+// extracted from each element (e.g., edges by label), and the merge
+// sort can run on multiple threads.
 
 #pragma once
 
-#include <cstring>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 // #include "binary_heap.h"
@@ -57,44 +66,233 @@ namespace sort {
     // This algorithm seems nicer with linked lists, since insertion
     // can be done in constant time (after finding the right
     // location).
+    for (std::size_t i = 1; i < v.size(); i++) {
+      T x = std::move(v[i]);
+      std::size_t j = i;
+      for (; j > 0 && x < v[j-1]; j--) {
+        v[j] = std::move(v[j-1]);
+      }
+      v[j] = std::move(x);
+    }
   }
 
   template <std::totally_ordered T>
   void heap_sort(std::vector<T> &v) {
+    // Sift the element at index [i] down the max-heap v[0, n).
+    auto sift_down = [&v](std::size_t i, std::size_t n) {
+      while (2 * i + 1 < n) {
+        std::size_t child = 2 * i + 1;
+        if (child + 1 < n && v[child] < v[child+1]) {
+          child++;
+        }
+        if (!(v[i] < v[child])) {
+          return;
+        }
+        std::swap(v[i], v[child]);
+        i = child;
+      }
+    };
+
+    // Build a max-heap, then repeatedly move its root to the end.
+    for (std::size_t i = v.size() / 2; i-- > 0;) {
+      sift_down(i, v.size());
+    }
+    for (std::size_t n = v.size(); n > 1; n--) {
+      std::swap(v[0], v[n-1]);
+      sift_down(0, n - 1);
+    }
+  }
+
+  // Subranges at most this long are insertion sorted by the merge
+  // sorts, and those at most 'parallel_cutoff' long aren't split
+  // among threads.
+  constexpr std::size_t insertion_cutoff = 16;
+  constexpr std::size_t parallel_cutoff = 1 << 14;
+
+  // Merge (stably) the sorted ranges src[a_lo, a_hi) and src[b_lo,
+  // b_hi) into dst starting at [out], on up to [threads] threads. The
+  // larger range is split at its middle element, which is placed
+  // directly and the two halves on either side merged in parallel.
+  template <typename T, typename Less>
+  void _merge(T *src, T *dst, std::size_t a_lo, std::size_t a_hi,
+              std::size_t b_lo, std::size_t b_hi, std::size_t out,
+              Less &less, uint threads) {
+    const std::size_t n = (a_hi - a_lo) + (b_hi - b_lo);
+    if (threads <= 1 || n <= parallel_cutoff) {
+      std::size_t i = a_lo, j = b_lo;
+      while (i < a_hi && j < b_hi) {
+        // Take from the first range on ties for stability.
+        if (less(src[j], src[i])) {
+          dst[out++] = std::move(src[j++]);
+        } else {
+          dst[out++] = std::move(src[i++]);
+        }
+      }
+      std::move(src + i, src + a_hi, dst + out);
+      std::move(src + j, src + b_hi, dst + out + (a_hi - i));
+      return;
+    }
+
+    std::size_t a_mid, b_mid;
+    if (a_hi - a_lo >= b_hi - b_lo) {
+      // Elements of b equal to the pivot go after it.
+      a_mid = (a_lo + a_hi) / 2;
+      b_mid = std::lower_bound(src + b_lo, src + b_hi, src[a_mid], less) - src;
+      dst[out + (a_mid - a_lo) + (b_mid - b_lo)] = std::move(src[a_mid]);
+      std::jthread left(_merge<T, Less>, src, dst, a_lo, a_mid, b_lo, b_mid,
+                        out, std::ref(less), threads / 2);
+      _merge(src, dst, a_mid + 1, a_hi, b_mid, b_hi,
+             out + (a_mid - a_lo) + (b_mid - b_lo) + 1, less, threads - threads / 2);
+    } else {
+      // Elements of a equal to the pivot go before it.
+      b_mid = (b_lo + b_hi) / 2;
+      a_mid = std::upper_bound(src + a_lo, src + a_hi, src[b_mid], less) - src;
+      dst[out + (a_mid - a_lo) + (b_mid - b_lo)] = std::move(src[b_mid]);
+      std::jthread left(_merge<T, Less>, src, dst, a_lo, a_mid, b_lo, b_mid,
+                        out, std::ref(less), threads / 2);
+      _merge(src, dst, a_mid, a_hi, b_mid + 1, b_hi,
+             out + (a_mid - a_lo) + (b_mid - b_lo) + 1, less, threads - threads / 2);
+    }
+  }
+
+  // Sort v[lo, hi) using buffer [buf] (of the same size as v) on up
+  // to [threads] threads.
+  template <typename T, typename Less>
+  void _merge_sort(T *v, T *buf, std::size_t lo, std::size_t hi,
+                   Less &less, uint threads) {
+    if (hi - lo <= insertion_cutoff) {
+      for (std::size_t i = lo + 1; i < hi; i++) {
+        T x = std::move(v[i]);
+        std::size_t j = i;
+        for (; j > lo && less(x, v[j-1]); j--) {
+          v[j] = std::move(v[j-1]);
+        }
+        v[j] = std::move(x);
+      }
+      return;
+    }
+
+    const std::size_t mid = (lo + hi) / 2;
+    if (threads <= 1 || hi - lo <= parallel_cutoff) {
+      _merge_sort(v, buf, lo, mid, less, 1);
+      _merge_sort(v, buf, mid, hi, less, 1);
+    } else {
+      std::jthread left(_merge_sort<T, Less>, v, buf, lo, mid, std::ref(less), threads / 2);
+      _merge_sort(v, buf, mid, hi, less, threads - threads / 2);
+    }
+
+    // Already in order (e.g., sorted input)?
+    if (!less(v[mid], v[mid-1])) {
+      return;
+    }
+    std::move(v + lo, v + hi, buf + lo);
+    _merge(buf, v, lo, mid, mid, hi, lo, less, threads);
+  }
+
+  inline uint default_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
   }
 
   template <std::totally_ordered T>
   void merge_sort(std::vector<T> &v) {
-    auto merge = [&v](uint lb, uint mid, uint ub) {
-      // TODO: Hmm.. is it possible without using extra space, and
-      // without requiring extra linear passes over the elements?'
-      uint sz = (ub-lb)*sizeof(uint);
-      uint *a = (uint*)std::malloc(sz);
-      std::memcpy(a, &v[lb], sz);
-
-      uint i = 0;
-      uint j = mid - lb;
-      for (uint k = lb; k < ub; k++) {
-	if (i < mid - lb && (j == ub - lb || a[i] < a[j])) {
-	  v[k] = a[i++];
-	} else {
-	  v[k] = a[j++];
-	}
-      }
+    if (v.size() > 1) {
+      std::vector<T> buf(v.size());
+      std::less<T> less;
+      _merge_sort(v.data(), buf.data(), 0, v.size(), less, 1);
+    }
+  }
 
-      std::free(a);
-    };
+  // Stable merge sort by [key] (a function from elements to a totally
+  // ordered type) on up to [threads] threads. Uses a single buffer,
+  // allocated with v's allocator.
+  template <typename T, typename A, typename Key>
+  requires std::totally_ordered<std::remove_cvref_t<std::invoke_result_t<Key&, const T&>>>
+  void parallel_merge_sort(std::vector<T, A> &v, Key key,
+                           uint threads = default_threads()) {
+    if (v.size() > 1) {
+      std::vector<T, A> buf(v.size(), v.get_allocator());
+      auto less = [&key](const T &a, const T &b) {
+        return key(a) < key(b);
+      };
+      _merge_sort(v.data(), buf.data(), 0, v.size(), less, threads);
+    }
+  }
+
+  template <std::totally_ordered T, typename A>
+  void parallel_merge_sort(std::vector<T, A> &v, uint threads = default_threads()) {
+    parallel_merge_sort(v, std::identity{}, threads);
+  }
+
+  // Unsigned integer that orders the same way as integral or floating
+  // point key [x] (the sign bit is flipped, and for negative floating
+  // point numbers all the other bits too).
+  template <common::Numeric K>
+  constexpr auto _radix_key(K x) {
+    if constexpr (std::unsigned_integral<K>) {
+      return x;
+    } else if constexpr (std::signed_integral<K>) {
+      using U = std::make_unsigned_t<K>;
+      return static_cast<U>(static_cast<U>(x) ^ (U{1} << (8 * sizeof(K) - 1)));
+    } else {
+      using U = std::conditional_t<sizeof(K) == 4, uint32_t, uint64_t>;
+      const U bits = std::bit_cast<U>(x);
+      const U sign = U{1} << (8 * sizeof(U) - 1);
+      return (bits & sign) ? static_cast<U>(~bits) : static_cast<U>(bits | sign);
+    }
+  }
 
-    std::function<void(uint, uint)> sort;
-    sort = [&merge, &sort](uint lb, uint ub) {
-      if (ub - lb <= 1) {
-        return;
+  // Stable LSD radix sort (one byte per pass) by [key], a function
+  // from elements to an integral or floating point type. Passes over
+  // bytes that are the same for all keys (e.g., the high bytes of
+  // small weights) are skipped. Uses a single buffer, allocated with
+  // v's allocator.
+  template <typename T, typename A, typename Key>
+  requires common::Numeric<std::remove_cvref_t<std::invoke_result_t<Key&, const T&>>>
+  void radix_sort(std::vector<T, A> &v, Key key) {
+    using U = decltype(_radix_key(key(std::declval<const T&>())));
+    constexpr uint passes = sizeof(U);
+    const std::size_t n = v.size();
+    if (n <= 1) {
+      return;
+    }
+
+    // Histograms of all the bytes, in a single pass.
+    std::array<std::array<std::size_t, 256>, passes> counts{};
+    for (const auto &x : v) {
+      const U k = _radix_key(key(x));
+      for (uint p = 0; p < passes; p++) {
+        counts[p][(k >> (8 * p)) & 0xff]++;
       }
-      uint mid = (lb + ub) / 2;
-      sort(lb, mid);
-      sort(mid, ub);
-      merge(lb, mid, ub);
-    };
-    sort(0, v.size());
+    }
+
+    std::vector<T, A> buf(n, v.get_allocator());
+    T *src = v.data();
+    T *dst = buf.data();
+    for (uint p = 0; p < passes; p++) {
+      const U first = _radix_key(key(src[0]));
+      if (counts[p][(first >> (8 * p)) & 0xff] == n) {
+        continue;
+      }
+      std::array<std::size_t, 256> offsets;
+      std::size_t sum = 0;
+      for (uint d = 0; d < 256; d++) {
+        offsets[d] = sum;
+        sum += counts[p][d];
+      }
+      for (std::size_t i = 0; i < n; i++) {
+        const U k = _radix_key(key(src[i]));
+        dst[offsets[(k >> (8 * p)) & 0xff]++] = std::move(src[i]);
+      }
+      std::swap(src, dst);
+    }
+
+    if (src != v.data()) {
+      std::move(src, src + n, v.data());
+    }
+  }
+
+  template <common::Numeric T, typename A>
+  void radix_sort(std::vector<T, A> &v) {
+    radix_sort(v, std::identity{});
   }
 }
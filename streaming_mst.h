@@ -0,0 +1,175 @@
+// Minimum spanning forest of a stream of edges, without building a
+// graph (semi-streaming Kruskal). Edges are buffered in batches, and
+// each full batch is merged with the current candidate forest and run
+// through Kruskal, keeping only the edges of the new forest. An edge
+// dropped this way is the heaviest on some cycle of the edges seen so
+// far, so it can't be in the final forest either.
+//
+// Memory is the forest (at most n - 1 edges), the batch buffer and a
+// union-find array, so O(n) in the number of vertices, however many
+// edges are streamed. The vertices are numbered in order of appearance
+// so the union-find is a flat array, reset on each merge.
+//
+// The batch grows with the forest to keep the merges amortized: it's
+// flushed once it holds at least as many edges as the forest (and at
+// least the minimum batch size). The forest is kept sorted by weight,
+// so each merge only sorts the new batch.
+//
+// Edges are taken as undirected. Isolated vertices never appear in
+// the stream, so they're simply absent from the forest.
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "common.h"
+#include "edge_file.h"
+#include "graph.h"
+#include "sort.h"
+
+template <typename V, common::Numeric E>
+class streaming_msf {
+public:
+  // Minimum number of edges buffered before a merge.
+  static constexpr std::size_t default_batch = 1 << 16;
+
+  explicit streaming_msf(std::size_t batch = default_batch)
+    : _batch(std::max<std::size_t>(1, batch)) {}
+
+  void add(const edge<V, E> &e) {
+    this->_buffer.push_back({this->_index(e.v1), this->_index(e.v2), e.label});
+    this->_seen++;
+    if (this->_buffer.size() >= std::max(this->_batch, this->_forest.size())) {
+      this->_merge();
+    }
+  }
+
+  // Add edges [es]. Callable with a span of edges so it can be used
+  // directly as a generator sink (see generators.h).
+  void operator()(std::span<const edge<V, E>> es) {
+    for (const auto &e : es) {
+      this->add(e);
+    }
+  }
+
+  // Minimum spanning forest of the edges added so far (sorted by
+  // weight).
+  std::vector<edge<V, E>> forest() {
+    this->_merge();
+    std::vector<edge<V, E>> result;
+    result.reserve(this->_forest.size());
+    for (const auto &e : this->_forest) {
+      result.push_back({this->_vertices[e.v1], this->_vertices[e.v2], e.label});
+    }
+    return result;
+  }
+
+  constexpr uint64_t num_edges_seen() const {
+    return this->_seen;
+  }
+
+  constexpr uint num_vertices_seen() const {
+    return this->_vertices.size();
+  }
+
+private:
+  // Edges are kept between vertex indices (in order of appearance),
+  // so the merges can use a flat union-find.
+  struct indexed_edge {
+    uint v1, v2;
+    E label;
+  };
+
+  std::size_t _batch;
+  std::unordered_map<V, uint> _indices;
+  std::vector<V> _vertices;
+  std::vector<indexed_edge> _forest;
+  std::vector<indexed_edge> _buffer;
+  std::vector<uint> _parent;
+  uint64_t _seen = 0;
+
+  uint _index(const V &v) {
+    auto [it, added] = this->_indices.try_emplace(v, this->_vertices.size());
+    if (added) {
+      this->_vertices.push_back(v);
+    }
+    return it->second;
+  }
+
+  uint _find(uint x) {
+    while (this->_parent[x] != x) {
+      this->_parent[x] = this->_parent[this->_parent[x]];
+      x = this->_parent[x];
+    }
+    return x;
+  }
+
+  // Replace the forest by the minimum spanning forest of the forest
+  // and the buffered edges.
+  void _merge() {
+    if (this->_buffer.empty()) {
+      return;
+    }
+    sort::radix_sort(this->_buffer, [](const indexed_edge &e) {
+      return e.label;
+    });
+    // Forest edges first among equal weights, so the forest only
+    // changes for strictly lighter edges.
+    std::vector<indexed_edge> candidates;
+    candidates.reserve(this->_forest.size() + this->_buffer.size());
+    std::merge(this->_forest.begin(), this->_forest.end(),
+               this->_buffer.begin(), this->_buffer.end(),
+               std::back_inserter(candidates), [](const indexed_edge &a, const indexed_edge &b) {
+                 return a.label < b.label;
+               });
+    this->_buffer.clear();
+
+    // Kruskal on the candidates (union by index, with path halving).
+    this->_parent.resize(this->_vertices.size());
+    std::iota(this->_parent.begin(), this->_parent.end(), 0u);
+    this->_forest.clear();
+    for (const auto &e : candidates) {
+      uint x = this->_find(e.v1);
+      uint y = this->_find(e.v2);
+      if (x != y) {
+        this->_forest.push_back(e);
+        this->_parent[std::max(x, y)] = std::min(x, y);
+      }
+    }
+  }
+};
+
+namespace streaming_mst {
+
+  // Minimum spanning forest of the edges in [first, last), read once,
+  // buffering at least [batch] edges per merge.
+  template <std::input_iterator I, std::sentinel_for<I> S>
+  auto mst(I first, S last, std::size_t batch = streaming_msf<int, int>::default_batch) {
+    using edge_type = std::iter_value_t<I>;
+    using V = decltype(edge_type::v1);
+    using E = decltype(edge_type::label);
+    streaming_msf<V, E> msf(batch);
+    for (; first != last; ++first) {
+      msf.add(*first);
+    }
+    return msf.forest();
+  }
+
+  // Minimum spanning forest of the edges of an edge file (see
+  // edge_file.h), read [batch] edges at a time.
+  template <typename V, common::Numeric E>
+  std::vector<edge<V, E>> mst(edge_file_reader<V, E> &in,
+                              std::size_t batch = streaming_msf<V, E>::default_batch) {
+    streaming_msf<V, E> msf(batch);
+    std::vector<edge<V, E>> es;
+    while (in.read(es, batch)) {
+      msf(es);
+    }
+    return msf.forest();
+  }
+}
@@ -0,0 +1,139 @@
+// Zero-copy subgraph views. A 'subgraph_view' wraps a graph (anything
+// satisfying common::Graph) together with a vertex predicate and an
+// edge predicate, and presents only the vertices that pass the first
+// and the edges that pass the second (and whose endpoints are both
+// kept). Nothing is copied: the vertices and edges are filtered on the
+// fly as the algorithms iterate over them, so e.g. "the road network
+// minus the closed roads" costs a predicate call per edge visited
+// instead of a copy of the network per query. Views satisfy
+// common::Graph themselves, so all the algorithms accept them (and
+// views of views).
+//
+// The view refers to the underlying graph, which must outlive it and
+// not change while it's in use. 'num_vertices' counts the vertices
+// that pass the predicate, so it takes linear time.
+
+#pragma once
+
+#include <concepts>
+#include <ranges>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+
+template <common::Graph G, typename VP, typename EP>
+requires std::predicate<const VP&, const common::vertex_t<G>&> &&
+         std::predicate<const EP&, const common::edge_t<G>&>
+class subgraph_view {
+public:
+  using vertex_type = common::vertex_t<G>;
+  using label_type = common::label_t<G>;
+
+  subgraph_view(const G &g, VP keep_vertex, EP keep_edge)
+    : _g(&g), _keep_vertex(std::move(keep_vertex)), _keep_edge(std::move(keep_edge)) {}
+
+  auto vertex_view() const {
+    return this->_g->vertex_view() | std::views::filter(this->_vertex_filter());
+  }
+
+  uint num_vertices() const {
+    uint n = 0;
+    for (const auto &v : this->_g->vertex_view()) {
+      n += this->_keep_vertex(v);
+    }
+    return n;
+  }
+
+  bool contains(const vertex_type &v) const {
+    return this->_g->contains(v) && this->_keep_vertex(v);
+  }
+
+  // View of the kept edges out of [v] (throws if [v] isn't in the
+  // view).
+  auto out_edges(const vertex_type &v) const {
+    if (!this->contains(v)) {
+      throw std::invalid_argument("vertex not in graph");
+    }
+    return this->_g->out_edges(v) | std::views::filter(this->_edge_filter());
+  }
+
+  std::vector<common::edge_t<G>> edges(const vertex_type &v) const {
+    std::vector<common::edge_t<G>> es;
+    for (const auto &e : this->out_edges(v)) {
+      es.push_back(e);
+    }
+    return es;
+  }
+
+  const G &base() const {
+    return *this->_g;
+  }
+
+private:
+  const G *_g;
+  VP _keep_vertex;
+  EP _keep_edge;
+
+  // Filters referring to this view's predicates (the view must
+  // outlive the ranges returned above).
+  auto _vertex_filter() const {
+    return [this](const vertex_type &v) {
+      return this->_keep_vertex(v);
+    };
+  }
+
+  auto _edge_filter() const {
+    return [this](const common::edge_t<G> &e) {
+      return this->_keep_edge(e) && this->_keep_vertex(e.v2);
+    };
+  }
+};
+
+namespace subgraph {
+
+  // Predicate keeping everything.
+  struct all {
+    template <typename T>
+    constexpr bool operator()(const T&) const {
+      return true;
+    }
+  };
+
+  // View of [g] with only the vertices satisfying [keep_vertex] and
+  // the edges satisfying [keep_edge].
+  template <common::Graph G, typename VP, typename EP>
+  subgraph_view<G, VP, EP> filtered(const G &g, VP keep_vertex, EP keep_edge) {
+    return {g, std::move(keep_vertex), std::move(keep_edge)};
+  }
+
+  template <common::Graph G, typename VP>
+  subgraph_view<G, VP, all> filter_vertices(const G &g, VP keep_vertex) {
+    return {g, std::move(keep_vertex), {}};
+  }
+
+  template <common::Graph G, typename EP>
+  subgraph_view<G, all, EP> filter_edges(const G &g, EP keep_edge) {
+    return {g, {}, std::move(keep_edge)};
+  }
+
+  // Subgraph of [g] induced by vertex set [vs] (which the view refers
+  // to, so it must outlive it).
+  template <common::Graph G>
+  auto induced(const G &g, const std::unordered_set<common::vertex_t<G>> &vs) {
+    return filter_vertices(g, [&vs](const common::vertex_t<G> &v) {
+      return vs.contains(v);
+    });
+  }
+
+  // Subgraph of [g] (with integer vertices) induced by the vertices
+  // whose bits are set in [bitmap] (which the view refers to).
+  template <common::Graph G>
+  requires std::integral<common::vertex_t<G>>
+  auto induced(const G &g, const std::vector<bool> &bitmap) {
+    return filter_vertices(g, [&bitmap](const common::vertex_t<G> &v) {
+      return v >= 0 && static_cast<std::size_t>(v) < bitmap.size() && bitmap[v];
+    });
+  }
+}
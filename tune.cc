@@ -0,0 +1,190 @@
+// Measures the crossovers between the algorithm variants adaptive.h
+// chooses from on this machine, and writes them to a profile file
+// (see adaptive::profile):
+//
+// - the number of vertices up to which Dijkstra and Prim with the
+//   scan queue beat the heap, on grid, random and geometric graphs
+//   of doubling size. The lowest crossover of the three is kept: past
+//   it the heap is at most a little slower on the other families,
+//   while the scan gets slower and slower on that one.
+// - the average degree up to which Kruskal beats Prim, on random
+//   graphs of increasing degree, with weights needing 1 to 4 radix
+//   sort passes (integers) and 8 (doubles); 5 to 7 are interpolated.
+//
+// Crossovers are interpolated between the measured points, taking
+// the log of the time ratio as linear in the log of the size. Takes
+// a minute or so. Usage:
+//
+//   ./tune [--out adaptive.profile] [--reps N] [--seed N]
+//          [--max-size N] [--mst-size N]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "adaptive.h"
+#include "dijkstra.h"
+#include "generators.h"
+#include "graph.h"
+#include "kruskal.h"
+#include "prim.h"
+
+using namespace std;
+
+struct options {
+  string out = "adaptive.profile";
+  uint reps = 3;
+  uint seed = 1;
+  uint max_size = 256000;
+  uint mst_size = 10000;
+};
+
+// Best of [reps] runs of [f], in seconds.
+double time_best(uint reps, const function<void()> &f) {
+  double best = numeric_limits<double>::max();
+  for (uint r = 0; r < reps; r++) {
+    const auto start = chrono::steady_clock::now();
+    f();
+    const chrono::duration<double> t = chrono::steady_clock::now() - start;
+    best = min(best, t.count());
+  }
+  return best;
+}
+
+graph<int, int> make_family(const string &family, uint n, uint seed) {
+  if (family == "grid") {
+    const uint side = max(2, static_cast<int>(sqrt(static_cast<double>(n))));
+    return gen::build(gen::grid<int, int>(side, side, seed, 9999));
+  } else if (family == "random") {
+    return gen::build(gen::erdos_renyi<int, int>(n, 4 * n, seed, 9999), false);
+  } else {
+    return gen::build(gen::geometric<int, int>(n, sqrt(8 / (M_PI * n)), seed, 9999));
+  }
+}
+
+// Where the log of time ratio [r0] at [x0] and [r1] at [x1] crosses 0.
+double interpolate(double x0, double r0, double x1, double r1) {
+  const double f = log(r0) / (log(r0) - log(r1));
+  return exp(log(x0) + f * (log(x1) - log(x0)));
+}
+
+// Number of vertices up to which [scan] beats [heap] on all graph
+// families.
+uint64_t scan_crossover(const options &opts, const string &what,
+                        const function<void(const graph<int, int>&)> &scan,
+                        const function<void(const graph<int, int>&)> &heap) {
+  vector<double> crossovers;
+  for (const string family : {"grid", "random", "geometric"}) {
+    // A loss only counts if the next size confirms it (the small
+    // sizes are noisy).
+    double last = 0, last_ratio = 0;
+    double crossover = opts.max_size;
+    optional<double> lost;
+    for (uint n = 1000; n <= opts.max_size; n *= 2) {
+      const auto g = make_family(family, n, opts.seed);
+      const double ts = time_best(opts.reps, [&] { scan(g); });
+      const double th = time_best(opts.reps, [&] { heap(g); });
+      cerr << what << " " << family << " " << g.num_vertices()
+           << ": scan " << ts << "s, heap " << th << "s" << endl;
+      const double ratio = ts / th;
+      if (ratio > 1 && lost) {
+        crossover = *lost;
+        break;
+      }
+      if (ratio > 1) {
+        lost = last ? interpolate(last, last_ratio, g.num_vertices(), ratio)
+          : g.num_vertices() / 2.0;
+        continue;
+      }
+      lost.reset();
+      last = g.num_vertices();
+      last_ratio = ratio;
+    }
+    crossovers.push_back(crossover);
+  }
+  return *std::min_element(crossovers.begin(), crossovers.end());
+}
+
+// Average degree up to which Kruskal beats Prim (with a heap) on
+// random graphs with weights in [1, max_weight].
+template <typename E>
+double kruskal_crossover(const options &opts, E max_weight) {
+  double last = 0, last_ratio = 0;
+  for (uint d = 2; d <= 256; d *= 2) {
+    const uint n = opts.mst_size;
+    const auto g = gen::build(gen::erdos_renyi<int, E>(n, static_cast<uint64_t>(n) * d / 2,
+                                                        opts.seed, max_weight), false);
+    const auto s = adaptive::measure(g);
+    const double tk = time_best(opts.reps, [&] { kruskal::mst(g); });
+    const double tp = time_best(opts.reps, [&] { prim::mst2(g); });
+    cerr << "mst degree " << s.avg_degree << " (" << s.sort_passes << " passes): kruskal "
+         << tk << "s, prim " << tp << "s" << endl;
+    const double ratio = tk / tp;
+    if (ratio > 1) {
+      return last ? interpolate(last, last_ratio, s.avg_degree, ratio) : s.avg_degree / 2;
+    }
+    last = s.avg_degree;
+    last_ratio = ratio;
+  }
+  return last;
+}
+
+int main(int argc, char **argv) {
+  options opts;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const string flag = argv[i];
+    const string value = argv[i+1];
+    if (flag == "--out") {
+      opts.out = value;
+    } else if (flag == "--reps") {
+      opts.reps = stoi(value);
+    } else if (flag == "--seed") {
+      opts.seed = stoi(value);
+    } else if (flag == "--max-size") {
+      opts.max_size = stod(value);
+    } else if (flag == "--mst-size") {
+      opts.mst_size = stod(value);
+    } else {
+      cerr << "unknown flag " << flag << endl;
+      return 1;
+    }
+  }
+
+  adaptive::profile p;
+
+  p.path_scan_max_vertices = scan_crossover(opts, "path", [](const graph<int, int> &g) {
+    dijkstra::shortest_path3(g, 0, g.num_vertices() - 1);
+  }, [](const graph<int, int> &g) {
+    dijkstra::shortest_path2(g, 0, g.num_vertices() - 1);
+  });
+  p.mst_scan_max_vertices = scan_crossover(opts, "mst", [](const graph<int, int> &g) {
+    prim::mst3(g);
+  }, [](const graph<int, int> &g) {
+    prim::mst2(g);
+  });
+
+  const int max_weights[] = {255, 65535, (1 << 24) - 1, numeric_limits<int>::max()};
+  for (uint k = 0; k < 4; k++) {
+    p.kruskal_max_degree[k] = kruskal_crossover(opts, max_weights[k]);
+  }
+  p.kruskal_max_degree[7] = kruskal_crossover(opts, 1.0);
+  for (uint k = 4; k < 7; k++) {
+    p.kruskal_max_degree[k] = p.kruskal_max_degree[3] +
+      (p.kruskal_max_degree[7] - p.kruskal_max_degree[3]) * (k - 3) / 4;
+  }
+
+  p.save(opts.out);
+  cout << "path_scan_max_vertices " << p.path_scan_max_vertices << endl
+       << "mst_scan_max_vertices " << p.mst_scan_max_vertices << endl
+       << "kruskal_max_degree";
+  for (const double d : p.kruskal_max_degree) {
+    cout << " " << d;
+  }
+  cout << endl << "wrote " << opts.out << endl;
+}
@@ -2,31 +2,48 @@
 
 #pragma once
 
+#include <memory_resource>
 #include <ranges>
+#include <unordered_map>
 #include <vector>
 
 #include "common.h"
 #include "graph.h"
+#include "instrument.h"
 
 template <typename T>
 class union_find {
 public:
+  union_find() : union_find(std::pmr::get_default_resource()) {}
+
+  explicit union_find(std::pmr::memory_resource *mr) : _nodes(mr) {}
+
   void add(const T &x) {
     if (!this->_nodes.contains(x)) {
       this->_nodes[x] = node{x, NULL, 0};
     }
   }
 
+  // Reserve space for [n] elements.
+  void reserve(uint n) {
+    this->_nodes.reserve(n);
+  }
+
   // T find(const T &x) {
   //   return this->_find(make_shared<node>(this->_nodes[x]))->el;
   // }
 
-  // Constant space version of 'find'.
-  T find(const T &x) {
+  // Constant space version of 'find'. The length of the path to the
+  // root is recorded by instrumentation policy [stats].
+  template <instrument::Policy S = instrument::none>
+  T find(const T &x, S &stats = instrument::off) {
     auto root = &this->_nodes[x];
+    uint64_t length = 0;
     while (root->parent) {
       root = root->parent;
+      length++;
     }
+    stats.uf_find(length);
 
     auto cur = &this->_nodes[x];
     while (cur->parent && cur->parent->el != root->el) {
@@ -38,9 +55,10 @@ public:
     return root->el;
   }
 
-  void set_union(const T &x, const T &y) {
-    node *x_root = &this->_nodes[this->find(x)];
-    node *y_root = &this->_nodes[this->find(y)];
+  template <instrument::Policy S = instrument::none>
+  void set_union(const T &x, const T &y, S &stats = instrument::off) {
+    node *x_root = &this->_nodes[this->find(x, stats)];
+    node *y_root = &this->_nodes[this->find(y, stats)];
 
     if (x_root->el != y_root->el) {
       if (x_root->rank < y_root->rank) {
@@ -62,7 +80,7 @@ private:
     node *parent;
     uint rank;
   };
-  std::unordered_map<T, node> _nodes;
+  std::pmr::unordered_map<T, node> _nodes;
 
   // std::shared_ptr<node> _find(const std::shared_ptr<node> &x) {
   //   if (x->parent) {
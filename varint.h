@@ -0,0 +1,157 @@
+// Byte-aligned variable length integer codecs, used by
+// compressed_graph.h:
+//
+// - LEB128: 7 bits per byte, the high bit set on all but the last
+//   byte. Simple, for the odd scattered value (e.g., a degree).
+// - Stream VByte (Lemire, Kurz & Rupp, "Stream VByte: Faster
+//   Byte-Oriented Integer Compression"): 32-bit values in groups of
+//   four, with a control byte holding the length (1 to 4 bytes) of
+//   each in 2 bits, followed by the values' bytes. Since the lengths
+//   are all known up front, a group decodes with a single byte shuffle
+//   (SSSE3's pshufb) looked up by control byte, with no branches. A
+//   group of fewer than four values leaves the unused lengths at 0
+//   and stores nothing for them.
+//
+// Signed values should be zigzag encoded first, so that small
+// negative values stay short.
+//
+// Decoding reads up to 16 bytes past the start of a group's values
+// whatever their length, so the buffer must have 'slack' bytes of
+// padding after the last group.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+  (defined(__x86_64__) || defined(__i386__))
+#define VARINT_X86 1
+#include <immintrin.h>
+#else
+#define VARINT_X86 0
+#endif
+
+namespace varint {
+
+  // Padding needed after the last Stream VByte group.
+  constexpr std::size_t slack = 16;
+
+  constexpr uint32_t zigzag(int32_t x) {
+    return (static_cast<uint32_t>(x) << 1) ^ static_cast<uint32_t>(x >> 31);
+  }
+
+  constexpr int32_t unzigzag(uint32_t x) {
+    return static_cast<int32_t>((x >> 1) ^ (0 - (x & 1)));
+  }
+
+  // Append [x] to byte container [out] in LEB128.
+  template <typename Out>
+  void put(Out &out, uint64_t x) {
+    while (x >= 0x80) {
+      out.push_back(static_cast<uint8_t>(x) | 0x80);
+      x >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(x));
+  }
+
+  // Read a LEB128 value at [p], advancing it.
+  inline uint64_t get(const uint8_t *&p) {
+    uint64_t x = 0;
+    for (uint shift = 0; ; shift += 7) {
+      const uint8_t b = *p++;
+      x |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if (b < 0x80) {
+        return x;
+      }
+    }
+  }
+
+  // Bytes of the values of a full group with control byte [ctrl].
+  constexpr std::array<uint8_t, 256> _lengths = [] {
+    std::array<uint8_t, 256> t{};
+    for (uint c = 0; c < 256; c++) {
+      t[c] = 4 + (c & 3) + ((c >> 2) & 3) + ((c >> 4) & 3) + ((c >> 6) & 3);
+    }
+    return t;
+  }();
+
+  // Shuffle moving the values of a group with control byte [ctrl] into
+  // four 32-bit lanes (0xff zeroes a byte).
+  constexpr std::array<std::array<uint8_t, 16>, 256> _shuffles = [] {
+    std::array<std::array<uint8_t, 16>, 256> t{};
+    for (uint c = 0; c < 256; c++) {
+      uint8_t src = 0;
+      for (uint lane = 0; lane < 4; lane++) {
+        const uint len = ((c >> (2 * lane)) & 3) + 1;
+        for (uint b = 0; b < 4; b++) {
+          t[c][4 * lane + b] = b < len ? src++ : 0xff;
+        }
+      }
+    }
+    return t;
+  }();
+
+  // Bytes of the values of a group of [count] (1 to 4) values with
+  // control byte [ctrl].
+  constexpr uint group_bytes(uint8_t ctrl, uint count) {
+    return _lengths[ctrl] - (4 - count);
+  }
+
+  // Append a group of values [xs][0..count) (1 to 4 of them) to [out]:
+  // the control byte, then the values.
+  template <typename Out>
+  void encode(Out &out, const uint32_t *xs, uint count) {
+    const std::size_t at = out.size();
+    out.push_back(0);
+    uint8_t ctrl = 0;
+    for (uint k = 0; k < count; k++) {
+      const uint32_t x = xs[k];
+      const uint len = x < (1u << 8) ? 1 : x < (1u << 16) ? 2 : x < (1u << 24) ? 3 : 4;
+      ctrl |= (len - 1) << (2 * k);
+      for (uint b = 0; b < len; b++) {
+        out.push_back(static_cast<uint8_t>(x >> (8 * b)));
+      }
+    }
+    out[at] = ctrl;
+  }
+
+  inline void _decode_scalar(const uint8_t *p, uint8_t ctrl, uint32_t *xs) {
+    for (uint k = 0; k < 4; k++) {
+      const uint len = ((ctrl >> (2 * k)) & 3) + 1;
+      uint32_t x;
+      std::memcpy(&x, p, 4);
+      xs[k] = len == 4 ? x : x & ((1u << (8 * len)) - 1);
+      p += len;
+    }
+  }
+
+#if VARINT_X86
+  __attribute__((target("ssse3")))
+  inline void _decode_ssse3(const uint8_t *p, uint8_t ctrl, uint32_t *xs) {
+    const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_shuffles[ctrl].data()));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(xs), _mm_shuffle_epi8(data, shuffle));
+  }
+
+  inline bool _has_ssse3() {
+    static const bool has = __builtin_cpu_supports("ssse3");
+    return has;
+  }
+#endif
+
+  // Decode the group with control byte [ctrl] whose values start at
+  // [p] into [xs][0..4) (values past the group's count are garbage).
+  inline void decode(const uint8_t *p, uint8_t ctrl, uint32_t *xs) {
+#if VARINT_X86
+    if (_has_ssse3()) {
+      _decode_ssse3(p, ctrl, xs);
+      return;
+    }
+#endif
+    _decode_scalar(p, ctrl, xs);
+  }
+}
+
+#undef VARINT_X86
@@ -0,0 +1,103 @@
+// Reusable scratch memory for graph algorithms. A workspace owns a
+// monotonic arena from which algorithms allocate their maps, vectors
+// and heaps (every algorithm takes an optional memory resource
+// argument). Rewinding the workspace between queries frees
+// everything at once. When a query overflows the arena, the next
+// rewind grows the backing buffer to the high-water mark, so a
+// long-running worker quickly reaches a steady state in which
+// queries perform no heap allocations at all. Typical use:
+//
+//   workspace ws;
+//   for (const auto &[src, dest] : queries) {
+//     auto path = dijkstra::shortest_path2(g, src, dest, ws.rewind());
+//     ...
+//   }
+//
+// A workspace is not thread-safe; give each worker thread its own.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+class workspace {
+public:
+  explicit workspace(std::size_t capacity = 1 << 16) {
+    this->_reset(capacity);
+  }
+
+  workspace(const workspace&) = delete;
+  workspace &operator=(const workspace&) = delete;
+
+  // Free everything allocated from the arena since the last rewind
+  // and return the arena, ready for the next query. Anything still
+  // referring to memory from the previous query becomes invalid.
+  std::pmr::memory_resource *rewind() {
+    if (this->_overflow.allocated()) {
+      // The arena requested more memory from the heap than it
+      // started with. Grow the buffer so it won't have to next time.
+      this->_reset(this->_capacity + this->_overflow.allocated());
+    } else {
+      this->_arena->release();
+    }
+    return &this->_arena.value();
+  }
+
+  // The arena, without rewinding it.
+  std::pmr::memory_resource *resource() {
+    return &this->_arena.value();
+  }
+
+  // Size of the arena's backing buffer in bytes.
+  constexpr std::size_t capacity() const {
+    return this->_capacity;
+  }
+
+private:
+  // Upstream resource of the arena, which only gets used when the
+  // arena runs out of space. Keeps track of how much that was.
+  class overflow_resource : public std::pmr::memory_resource {
+  public:
+    constexpr std::size_t allocated() const {
+      return this->_allocated;
+    }
+
+    void reset() {
+      this->_allocated = 0;
+    }
+
+  private:
+    std::size_t _allocated = 0;
+
+    void *do_allocate(std::size_t bytes, std::size_t align) override {
+      this->_allocated += bytes;
+      return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t align) override {
+      std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &r) const noexcept override {
+      return this == &r;
+    }
+  };
+
+  std::unique_ptr<std::byte[]> _buffer;
+  std::size_t _capacity;
+  overflow_resource _overflow;
+  std::optional<std::pmr::monotonic_buffer_resource> _arena;
+
+  // Replace the backing buffer with one of [capacity] bytes.
+  void _reset(std::size_t capacity) {
+    // Release the old arena (and any overflow memory) before freeing
+    // the buffer it points into.
+    this->_arena.reset();
+    this->_overflow.reset();
+    this->_buffer = std::make_unique_for_overwrite<std::byte[]>(capacity);
+    this->_capacity = capacity;
+    this->_arena.emplace(this->_buffer.get(), capacity, &this->_overflow);
+  }
+};